@@ -0,0 +1,185 @@
+/**
+ * @file bench_find.c
+ * @brief string_find_c benchmark: allocating strstr search vs string_memfind
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Build (from repository root):
+ *   gcc -O2 -Istringslib -Istringslib/siphash stringslib/strings.c stringslib/siphash/siphash.c stringslib/siphash/halfsiphash.c \
+ *       bench/bench_find.c -o bench_find
+ *   (add -mavx2 for the AVX2 path, SSE2 is the default on x86-64)
+ *
+ * Run from repository root:
+ *   ./bench_find [rounds]
+ *
+ * Lines: every line of test1.il and test2.il is searched for the needles used
+ * by the parser. Scan: a 1 MiB buffer made of the same sources is searched for
+ * needles that are not found (throughput of a full scan).
+ * Old implementation (temporary String + strstr) is kept here as reference.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "strings.h"
+
+#define SCAN_SIZE (1024 * 1024)
+
+static const char *needles[] = { ":", ";", "#", " ", ":=", "=>", "(*", "END_VAR" };
+static const char *missing[] = { "@", "@@", "NOT_THERE", " @", ":=@" }; // rare and common first byte
+
+#define NEEDLES_QTY (sizeof(needles) / sizeof(needles[0]))
+#define MISSING_QTY (sizeof(missing) / sizeof(missing[0]))
+
+// string_find_c before string_memfind
+static uint32_t find_old(const String buf, const char *csearch, uint32_t pos) {
+    if (buf == NULL || csearch == NULL || pos > buf->length)
+        return STR_ERROR;
+
+    String search = string_new_c(csearch);
+    uint32_t p = STR_ERROR;
+    char *s;
+
+    if (search->length <= buf->length && (s = strstr(buf->data + pos, search->data)) != NULL)
+        p = s - buf->data;
+    string_free(search);
+
+    return p;
+}
+
+static double elapsed(struct timespec *start, struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static uint32_t load_lines(const char *file, String *lines, uint32_t qty, char *src, uint32_t *src_len) {
+    char line[1024];
+    FILE *in;
+
+    if ((in = fopen(file, "rb")) == NULL) {
+        fprintf(stderr, "ERROR: can't open %s (run from repository root)\n", file);
+        exit(1);
+    }
+
+    while (fgets(line, sizeof(line), in) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        lines[qty] = string_new_c(line);
+        memcpy(src + *src_len, line, lines[qty]->length);
+        *src_len += lines[qty++]->length;
+        src[(*src_len)++] = '\n';
+    }
+    fclose(in);
+
+    return qty;
+}
+
+int main(int argc, char **argv) {
+    struct timespec t0, t1;
+    String lines[512], big;
+    static char src[64 * 1024];
+    uint32_t qty = 0, src_len = 0;
+    volatile uint32_t sink = 0;
+    double t_old, t_new;
+    long rounds = 20000;
+
+    if (argc > 1)
+        rounds = strtol(argv[1], NULL, 10);
+
+    qty = load_lines("test1.il", lines, qty, src, &src_len);
+    qty = load_lines("test2.il", lines, qty, src, &src_len);
+
+    // 1 MiB of source without '@'
+    big = string_new(SCAN_SIZE);
+    while (big->length + src_len <= SCAN_SIZE) {
+        memcpy(big->data + big->length, src, src_len);
+        big->length += src_len;
+    }
+    big->data[big->length] = '\0';
+
+    // both must agree
+    for (uint32_t l = 0; l < qty; l++) {
+        for (uint32_t n = 0; n < NEEDLES_QTY; n++) {
+            for (uint32_t pos = 0; pos <= lines[l]->length; pos++) {
+                if (find_old(lines[l], needles[n], pos) != string_find_c(lines[l], needles[n], pos)) {
+                    fprintf(stderr, "ERROR: mismatch [%s] in [%s] at %u\n", needles[n], lines[l]->data, pos);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    printf("[lines: %u, needles: %zu, rounds: %ld]\n", qty, NEEDLES_QTY, rounds);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long r = 0; r < rounds; r++)
+        for (uint32_t l = 0; l < qty; l++)
+            for (uint32_t n = 0; n < NEEDLES_QTY; n++)
+                sink += find_old(lines[l], needles[n], 0);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t_old = elapsed(&t0, &t1);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long r = 0; r < rounds; r++)
+        for (uint32_t l = 0; l < qty; l++)
+            for (uint32_t n = 0; n < NEEDLES_QTY; n++)
+                sink += string_find_c(lines[l], needles[n], 0);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t_new = elapsed(&t0, &t1);
+
+    printf("    [old: %.3f s (%.1f ns per search)]\n", t_old, t_old * 1e9 / (rounds * qty * NEEDLES_QTY));
+    printf("    [new: %.3f s (%.1f ns per search)]\n", t_new, t_new * 1e9 / (rounds * qty * NEEDLES_QTY));
+    printf("    [speedup: %.1fx]\n", t_old / t_new);
+
+    printf("[scan: %u bytes, needles not found]\n", big->length);
+    for (uint32_t n = 0; n < MISSING_QTY; n++) {
+        long scans = rounds / 10 + 1;
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (long r = 0; r < scans; r++)
+            sink += find_old(big, missing[n], 0);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        t_old = elapsed(&t0, &t1);
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (long r = 0; r < scans; r++)
+            sink += string_find_c(big, missing[n], 0);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        t_new = elapsed(&t0, &t1);
+
+        printf("    [%-9s old: %6.2f GB/s, new: %6.2f GB/s, speedup: %.1fx]\n", missing[n],
+                scans * big->length / t_old / 1e9, scans * big->length / t_new / 1e9, t_old / t_new);
+    }
+
+    for (uint32_t l = 0; l < qty; l++)
+        string_free(lines[l]);
+    string_free(big);
+
+    return 0;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file bench_opcode.c
+ * @brief Opcode recognizer microbenchmark: perfect hash vs linear scan
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Build (from repository root):
+ *   gcc -O2 -Isrc -Istringslib -Istringslib/siphash src/il_parser.c src/il_lexer.c src/il_arena.c src/il_alloc.c stringslib/strings.c \
+ *       stringslib/siphash/siphash.c stringslib/siphash/halfsiphash.c bench/bench_opcode.c -o bench_opcode
+ *
+ * Run from repository root:
+ *   ./bench_opcode [rounds]
+ *
+ * The mnemonic mix is every opcode of test1.il and test2.il as written in the
+ * source (mixed case, function block calls included). Each round looks up the
+ * whole mix with the old linear scan (upper case copy + strlen/memcmp against
+ * all commands) and with il_lexer_command().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "il_parser.h"
+#include "il_lexer.h"
+
+#define MIX_MAX 1024
+
+typedef struct mnemonic_s {
+    const char *str; //
+      uint32_t len;  //
+} mnemonic_t;
+
+static const char *old_commands[] = {
+    "LD", "LDN", "ST", "STN", "S", "R", "AND", "&", "ANDN", "&N", "OR", "ORN", "XOR", "XORN", "AND(", "&(", "ANDN(", "&N(", "OR(", "ORN(",
+    "XOR(", "XORN(", "ADD", "SUB", "MUL", "DIV", "GT", "GE", "EQ", "NE", "LE", "LT", "ADD(", "SUB(", "MUL(", "DIV(", "GT(", "GE(", "EQ(",
+    "NE(", "LE(", "LT(", "JMP", "JMPC", "JMPCN", "JMPNC", "CAL", "CALC", "CALCN", "CALNC", "RET", "RETC", "RETCN", "RETNC", ")",
+    "VAR_OUTPUT", "VAR"
+};
+
+// previous lookup: upper case copy and linear scan
+static int old_lookup(const char *mnemonic, uint32_t len) {
+    char *upper = malloc(len + 1);
+    int result = -1;
+
+    for (uint32_t n = 0; n < len; n++)
+        upper[n] = (mnemonic[n] >= 'a' && mnemonic[n] <= 'z') ? mnemonic[n] - 32 : mnemonic[n];
+    upper[len] = '\0';
+
+    for (int cmd = 0; cmd < 57; cmd++) {
+        if (strlen(old_commands[cmd]) == len && !memcmp(upper, old_commands[cmd], len)) {
+            result = cmd;
+            break;
+        }
+    }
+    free(upper);
+
+    return result;
+}
+
+static char* load(const char *file, uint32_t *len) {
+    FILE *f;
+    char *src;
+    long size;
+
+    if ((f = fopen(file, "rb")) == NULL) {
+        fprintf(stderr, "ERROR: can't open %s (run from repository root)\n", file);
+        exit(1);
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    rewind(f);
+    src = malloc(size + 1);
+    *len = fread(src, 1, size, f);
+    src[*len] = '\0';
+    fclose(f);
+
+    return src;
+}
+
+static uint32_t collect(const char *src, uint32_t len, mnemonic_t *mix, uint32_t qty) {
+    il_lexer_t lexer;
+    il_token_t tok;
+
+    il_lexer_init(&lexer, src, len);
+    while (il_lexer_next(&lexer, &tok) && qty < MIX_MAX) {
+        if (tok.kind == IL_TK_OPCODE) {
+            mix[qty].str = src + tok.src;
+            mix[qty].len = tok.len;
+            ++qty;
+        }
+    }
+    il_lexer_free(&lexer);
+
+    return qty;
+}
+
+static double elapsed(struct timespec *start, struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(int argc, char **argv) {
+    mnemonic_t mix[MIX_MAX];
+    struct timespec t0, t1;
+    double t_old, t_new;
+    uint32_t qty = 0, len1, len2;
+    long rounds = 200000;
+    volatile uintptr_t sink = 0;
+    char *src1, *src2;
+    int stdout_fd;
+
+    if (argc > 1)
+        rounds = strtol(argv[1], NULL, 10);
+
+    src1 = load("test1.il", &len1);
+    src2 = load("test2.il", &len2);
+
+    // lexer traces to /dev/null
+    fflush(stdout);
+    stdout_fd = dup(STDOUT_FILENO);
+    if (freopen("/dev/null", "w", stdout) == NULL)
+        return 1;
+    qty = collect(src1, len1, mix, qty);
+    qty = collect(src2, len2, mix, qty);
+    fflush(stdout);
+    dup2(stdout_fd, STDOUT_FILENO);
+    close(stdout_fd);
+
+    // both lookups must agree
+    for (uint32_t n = 0; n < qty; n++) {
+        const il_str_t *cmd = il_lexer_command(mix[n].str, mix[n].len);
+        int old = old_lookup(mix[n].str, mix[n].len);
+
+        if ((cmd == NULL) != (old == -1) || (cmd != NULL && strcmp(cmd->str, old_commands[old]))) {
+            fprintf(stderr, "ERROR: lookup mismatch [%.*s]\n", (int) mix[n].len, mix[n].str);
+            return 1;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long r = 0; r < rounds; r++)
+        for (uint32_t n = 0; n < qty; n++)
+            sink += old_lookup(mix[n].str, mix[n].len);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t_old = elapsed(&t0, &t1);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long r = 0; r < rounds; r++)
+        for (uint32_t n = 0; n < qty; n++)
+            sink += (uintptr_t) il_lexer_command(mix[n].str, mix[n].len);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t_new = elapsed(&t0, &t1);
+
+    printf("[mnemonics: %u, rounds: %ld]\n", qty, rounds);
+    printf("    [linear scan: %.3f s (%.1f ns per lookup)]\n", t_old, t_old * 1e9 / (rounds * qty));
+    printf("    [perfect hash: %.3f s (%.1f ns per lookup)]\n", t_new, t_new * 1e9 / (rounds * qty));
+    printf("    [speedup: %.1fx]\n", t_old / t_new);
+
+    free(src1);
+    free(src2);
+
+    return 0;
+}
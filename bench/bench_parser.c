@@ -0,0 +1,206 @@
+/**
+ * @file bench_parser.c
+ * @brief Parser benchmark: allocations and time per instruction
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Build (from repository root, glibc only):
+ *   gcc -O2 -Isrc -Istringslib -Istringslib/siphash src/il_parser.c src/il_lexer.c src/il_arena.c src/il_alloc.c stringslib/strings.c \
+ *       stringslib/siphash/siphash.c stringslib/siphash/halfsiphash.c bench/bench_parser.c -o bench_parser
+ *
+ * Run from repository root:
+ *   ./bench_parser [scale]
+ *
+ * test1.il and test2.il are concatenated <scale> times (default 10000) into a
+ * temporary file which is parsed twice: with the console listener (output to
+ * /dev/null) and without listener.
+ * Then <scale> * 8 forward jumps (JMP Ln ... Ln:) are parsed from a buffer
+ * to track label resolution (linear in jumps).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "il_parser.h"
+
+/////////////////////// allocation count //////////////////////
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t nmemb, size_t size);
+extern void* __libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static uint64_t alloc_count = 0;
+static uint64_t alloc_bytes = 0;
+static uint64_t free_count = 0;
+
+void* malloc(size_t size) {
+    ++alloc_count;
+    alloc_bytes += size;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t nmemb, size_t size) {
+    ++alloc_count;
+    alloc_bytes += nmemb * size;
+    return __libc_calloc(nmemb, size);
+}
+
+void* realloc(void *ptr, size_t size) {
+    ++alloc_count;
+    alloc_bytes += size;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    if (ptr != NULL)
+        ++free_count;
+    __libc_free(ptr);
+}
+
+///////////////////////////////////////////////////////////////
+
+static size_t append_file(FILE *out, const char *file) {
+    char buffer[4096];
+    size_t len, total = 0;
+    FILE *in;
+
+    if ((in = fopen(file, "rb")) == NULL) {
+        fprintf(stderr, "ERROR: can't open %s (run from repository root)\n", file);
+        exit(1);
+    }
+
+    while ((len = fread(buffer, 1, sizeof(buffer), in)) > 0)
+        total += fwrite(buffer, 1, len, out);
+    fputc('\n', out);
+    fclose(in);
+
+    return total + 1;
+}
+
+static double elapsed(struct timespec *start, struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static const char *mem_phase_str[] = {
+    "load",     // IL_MEM_LOAD
+    "lexer",    // IL_MEM_LEXER
+    "labels",   // IL_MEM_LABELS
+    "literals", // IL_MEM_LITERALS
+};
+
+int main(int argc, char **argv) {
+    char file[] = "/tmp/il_bench_XXXXXX";
+    struct timespec t0, t1, t2, t3, t4, t5;
+    uint64_t allocs, bytes, frees;
+    parsed_il_t parsed;
+    il_mem_stats_t mem;
+    size_t size = 0;
+    long scale = 10000;
+    int lines;
+    int stdout_fd, fd;
+    FILE *out;
+    char *jumps;
+    size_t jumps_len;
+    long jumps_qty;
+
+    if (argc > 1)
+        scale = strtol(argv[1], NULL, 10);
+
+    if ((fd = mkstemp(file)) == -1 || (out = fdopen(fd, "wb")) == NULL) {
+        fprintf(stderr, "ERROR: can't create temporary file\n");
+        return 1;
+    }
+    for (long n = 0; n < scale; n++) {
+        size += append_file(out, "test1.il");
+        size += append_file(out, "test2.il");
+    }
+    fclose(out);
+
+    // console output to /dev/null
+    fflush(stdout);
+    stdout_fd = dup(STDOUT_FILENO);
+    if (freopen("/dev/null", "w", stdout) == NULL)
+        return 1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    parse_file_il(file, &parsed, &il_console_listener);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    free_parsed_il(&parsed);
+
+    fflush(stdout);
+    dup2(stdout_fd, STDOUT_FILENO);
+    close(stdout_fd);
+
+    // quiet
+    alloc_count = alloc_bytes = free_count = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    parse_file_il(file, &parsed, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t3);
+    allocs = alloc_count;
+    bytes = alloc_bytes;
+
+    lines = parsed.lines;
+    mem = parsed.mem;
+    free_parsed_il(&parsed);
+    frees = free_count;
+    unlink(file);
+
+    // forward jumps: every label is defined after all jumps
+    jumps_qty = scale * 8;
+    out = open_memstream(&jumps, &jumps_len);
+    for (long n = 0; n < jumps_qty; n++)
+        fprintf(out, "    JMP L%ld\n", n);
+    for (long n = 0; n < jumps_qty; n++)
+        fprintf(out, "L%ld: LD 1\n", n);
+    fclose(out);
+
+    clock_gettime(CLOCK_MONOTONIC, &t4);
+    parse_buffer_il(jumps, jumps_len, &parsed, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t5);
+    free_parsed_il(&parsed);
+    free(jumps);
+
+    printf("[scale: %ld, source: %zu bytes, instructions: %d]\n", scale, size, lines);
+    printf("    [allocations: %" PRIu64 " (%.2f per instruction), requested: %" PRIu64 " bytes]\n", allocs, (double) allocs / lines, bytes);
+    printf("    [frees: %" PRIu64 "]\n", frees);
+    printf("    [parse time (console): %.3f s (%.1f ns per instruction)]\n", elapsed(&t0, &t1), elapsed(&t0, &t1) * 1e9 / lines);
+    printf("    [parse time (quiet):   %.3f s (%.1f ns per instruction)]\n", elapsed(&t2, &t3), elapsed(&t2, &t3) * 1e9 / lines);
+    printf("    [parse time (forward jumps: %ld): %.3f s (%.1f ns per jump)]\n", jumps_qty, elapsed(&t4, &t5), elapsed(&t4, &t5) * 1e9 / jumps_qty);
+    printf("    [memory (quiet): allocations: %" PRIu64 ", requested: %" PRIu64 " bytes, peak: %" PRIu64 " bytes]\n", mem.allocs, mem.bytes, mem.peak);
+    for (int p = 0; p < IL_MEM_PHASES; p++)
+        printf("        [%-8s: allocations: %" PRIu64 ", requested: %" PRIu64 " bytes, peak: %" PRIu64 " bytes]\n", mem_phase_str[p],
+                mem.phase[p].allocs, mem.phase[p].bytes, mem.phase[p].peak);
+
+    return 0;
+}
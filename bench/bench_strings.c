@@ -0,0 +1,169 @@
+/**
+ * @file bench_strings.c
+ * @brief Strings benchmark: heap and inline (small string) token copies
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Build (from repository root, glibc only):
+ *   gcc -O2 -Istringslib -Istringslib/siphash stringslib/strings.c stringslib/siphash/siphash.c stringslib/siphash/halfsiphash.c \
+ *       bench/bench_strings.c -o bench_strings
+ *
+ * Run from repository root:
+ *   ./bench_strings [rounds]
+ *
+ * Each round takes every token of the mix (operands and mnemonics as found in
+ * test1.il and test2.il) through string_new_c, string_left and string_right,
+ * first with heap Strings and then with the *_sso variants on the stack (the
+ * last token does not fit inline).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include "strings.h"
+
+/////////////////////// allocation count //////////////////////
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t nmemb, size_t size);
+extern void* __libc_realloc(void *ptr, size_t size);
+
+static uint64_t alloc_count = 0;
+
+void* malloc(size_t size) {
+    ++alloc_count;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t nmemb, size_t size) {
+    ++alloc_count;
+    return __libc_calloc(nmemb, size);
+}
+
+void* realloc(void *ptr, size_t size) {
+    ++alloc_count;
+    return __libc_realloc(ptr, size);
+}
+
+///////////////////////////////////////////////////////////////
+
+static const char *mix[] = {
+    "LD", "%IX0.4", "OR(", "%I1.2", "AND(", ")", "S", "ST", "%QX0.0", "145", "Limit", "FUNC.IV", "JMPC", "lbl_1", "TRUE",
+    "T#1h2m", "D#2023-01-02", "16#FF", "-12.5e3", "RESET", "PVv_5", "_aCU", "OUT1", "FO1", "CTU", "CMD_TMR", "ELAPSED",
+    "GEN_FUN_EXP ( RESET:=PHY#IX3.6, PVv_5:=Limit )" // longer than STRING_SSO_CAP
+};
+
+#define MIX_QTY (sizeof(mix) / sizeof(mix[0]))
+
+static double elapsed(struct timespec *start, struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(int argc, char **argv) {
+    struct timespec t0, t1;
+    uint64_t heap_allocs, sso_allocs;
+    double t_heap, t_sso;
+    volatile uint32_t sink = 0;
+    long rounds = 2000000;
+
+    if (argc > 1)
+        rounds = strtol(argv[1], NULL, 10);
+
+    // both must agree
+    for (uint32_t n = 0; n < MIX_QTY; n++) {
+        string_sso_t sso;
+        String heap = string_new_c(mix[n]);
+
+        for (uint32_t pos = 0; pos < heap->length; pos++) {
+            String a = string_left(heap, pos), b = string_left_sso(&sso, heap, pos);
+            bool same = string_equals(a, b);
+
+            free(a);
+            string_sso_free(&sso, b);
+            a = string_right(heap, pos);
+            b = string_right_sso(&sso, heap, pos);
+            same = same && string_equals(a, b);
+            free(a);
+            string_sso_free(&sso, b);
+
+            if (!same) {
+                fprintf(stderr, "ERROR: mismatch [%s] at %u\n", mix[n], pos);
+                return 1;
+            }
+        }
+        free(heap);
+    }
+
+    alloc_count = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long r = 0; r < rounds; r++) {
+        for (uint32_t n = 0; n < MIX_QTY; n++) {
+            String tok = string_new_c(mix[n]);
+            String left = string_left(tok, tok->length / 2);
+            String right = string_right(tok, tok->length / 2);
+
+            sink += tok->length + left->length + right->length;
+            free(tok);
+            free(left);
+            free(right);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t_heap = elapsed(&t0, &t1);
+    heap_allocs = alloc_count;
+
+    alloc_count = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long r = 0; r < rounds; r++) {
+        for (uint32_t n = 0; n < MIX_QTY; n++) {
+            string_sso_t tok_sso, left_sso, right_sso;
+            String tok = string_new_c_sso(&tok_sso, mix[n]);
+            String left = string_left_sso(&left_sso, tok, tok->length / 2);
+            String right = string_right_sso(&right_sso, tok, tok->length / 2);
+
+            sink += tok->length + left->length + right->length;
+            string_sso_free(&tok_sso, tok);
+            string_sso_free(&left_sso, left);
+            string_sso_free(&right_sso, right);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t_sso = elapsed(&t0, &t1);
+    sso_allocs = alloc_count;
+
+    printf("[tokens: %zu, rounds: %ld, inline capacity: %d]\n", MIX_QTY, rounds, STRING_SSO_CAP);
+    printf("    [heap:   %.3f s (%.1f ns per token), allocations: %" PRIu64 "]\n", t_heap, t_heap * 1e9 / (rounds * MIX_QTY), heap_allocs);
+    printf("    [inline: %.3f s (%.1f ns per token), allocations: %" PRIu64 "]\n", t_sso, t_sso * 1e9 / (rounds * MIX_QTY), sso_allocs);
+    printf("    [speedup: %.1fx]\n", t_heap / t_sso);
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+/**
+ * @file bench_trim.c
+ * @brief Trim benchmark: allocating isspace trim vs string_memltrim/string_memrtrim
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Build (from repository root):
+ *   gcc -O2 -Istringslib -Istringslib/siphash stringslib/strings.c stringslib/siphash/siphash.c stringslib/siphash/halfsiphash.c \
+ *       bench/bench_trim.c -o bench_trim
+ *   (add -mavx2 for the AVX2 path, SSE2 is the default on x86-64)
+ *
+ * Run from repository root:
+ *   ./bench_trim [rounds]
+ *
+ * Every line of test1.il and test2.il (leading indentation, trailing blanks
+ * and comments) is trimmed: allocating string_trim, string_trim_view (offsets,
+ * no copy) and string_trim_m (in place, on a copy of the line restored each time).
+ * Old implementation (isspace and allocation) is kept here as reference.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <time.h>
+
+#include "strings.h"
+
+// string_trim before string_memltrim/string_memrtrim (all blank lines kept valid)
+static String trim_old(const String buf) {
+    int32_t pos1 = 0, pos2 = buf->length - 1;
+
+    while (pos1 < buf->length && isspace(buf->data[pos1]))
+        ++pos1;
+    while (pos2 >= pos1 && isspace(buf->data[pos2]))
+        --pos2;
+
+    String new = string_new(pos2 - pos1 + 1);
+    memcpy(new->data, buf->data + pos1, pos2 - pos1 + 1);
+    new->length = pos2 - pos1 + 1;
+
+    return new;
+}
+
+// string_isblank before string_memltrim
+static bool isblank_old(const String buf) {
+    for (char *ch = buf->data; *ch != '\0'; ++ch) {
+        if (!isspace(*ch))
+            return false;
+    }
+
+    return true;
+}
+
+static double elapsed(struct timespec *start, struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static uint32_t load_lines(const char *file, String *lines, uint32_t qty) {
+    char line[1024];
+    FILE *in;
+
+    if ((in = fopen(file, "rb")) == NULL) {
+        fprintf(stderr, "ERROR: can't open %s (run from repository root)\n", file);
+        exit(1);
+    }
+
+    while (fgets(line, sizeof(line), in) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        lines[qty++] = string_new_c(line);
+    }
+    fclose(in);
+
+    return qty;
+}
+
+static void report(const char *name, double t, double base, long searches) {
+    printf("    [%-8s %.3f s (%5.1f ns per line), speedup: %.1fx]\n", name, t, t * 1e9 / searches, base / t);
+}
+
+int main(int argc, char **argv) {
+    struct timespec t0, t1;
+    String lines[512], work;
+    uint32_t qty = 0, start;
+    volatile uint32_t sink = 0;
+    double t_old, t;
+    long rounds = 100000;
+
+    if (argc > 1)
+        rounds = strtol(argv[1], NULL, 10);
+
+    qty = load_lines("test1.il", lines, qty);
+    qty = load_lines("test2.il", lines, qty);
+    work = string_new(1024);
+
+    // all must agree
+    for (uint32_t l = 0; l < qty; l++) {
+        String a = trim_old(lines[l]), b = string_trim(lines[l]);
+        uint32_t len = string_trim_view(lines[l], &start);
+
+        if (!string_equals(a, b) || len != a->length || memcmp(lines[l]->data + start, a->data, len)
+                || isblank_old(lines[l]) != string_isblank(lines[l])) {
+            fprintf(stderr, "ERROR: mismatch in [%s]\n", lines[l]->data);
+            return 1;
+        }
+        string_free(a);
+        string_free(b);
+    }
+
+    printf("[lines: %u, rounds: %ld]\n", qty, rounds);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long r = 0; r < rounds; r++)
+        for (uint32_t l = 0; l < qty; l++) {
+            String s = trim_old(lines[l]);
+            sink += s->length;
+            string_free(s);
+        }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t_old = elapsed(&t0, &t1);
+    report("old:", t_old, t_old, rounds * qty);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long r = 0; r < rounds; r++)
+        for (uint32_t l = 0; l < qty; l++) {
+            String s = string_trim(lines[l]);
+            sink += s->length;
+            string_free(s);
+        }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed(&t0, &t1);
+    report("copy:", t, t_old, rounds * qty);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long r = 0; r < rounds; r++)
+        for (uint32_t l = 0; l < qty; l++)
+            sink += string_trim_view(lines[l], &start) + start;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed(&t0, &t1);
+    report("view:", t, t_old, rounds * qty);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long r = 0; r < rounds; r++)
+        for (uint32_t l = 0; l < qty; l++) {
+            memcpy(work->data, lines[l]->data, lines[l]->length + 1);
+            work->length = lines[l]->length;
+            string_trim_m(work);
+            sink += work->length;
+        }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed(&t0, &t1);
+    report("in place:", t, t_old, rounds * qty);
+
+    printf("[blank]\n");
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long r = 0; r < rounds; r++)
+        for (uint32_t l = 0; l < qty; l++)
+            sink += isblank_old(lines[l]);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t_old = elapsed(&t0, &t1);
+    report("old:", t_old, t_old, rounds * qty);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long r = 0; r < rounds; r++)
+        for (uint32_t l = 0; l < qty; l++)
+            sink += string_isblank(lines[l]);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    t = elapsed(&t0, &t1);
+    report("new:", t, t_old, rounds * qty);
+
+    for (uint32_t l = 0; l < qty; l++)
+        string_free(lines[l]);
+    string_free(work);
+
+    return 0;
+}
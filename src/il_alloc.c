@@ -0,0 +1,263 @@
+/**
+ * @file il_alloc.c
+ * @brief memory hooks and accounting
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "il_alloc.h"
+#include "strings.h"
+
+// size of block, data keeps the largest alignment of parser data
+typedef union il_mem_header_u {
+         size_t size;   //
+    long double align;  //
+} il_mem_header_t;
+
+static void* libc_alloc(void *ctx, size_t size) {
+    (void) ctx;
+
+    return malloc(size);
+}
+
+static void* libc_realloc(void *ctx, void *ptr, size_t old_size, size_t size) {
+    (void) ctx;
+    (void) old_size;
+
+    return realloc(ptr, size);
+}
+
+static void libc_free(void *ctx, void *ptr, size_t size) {
+    (void) ctx;
+    (void) size;
+
+    free(ptr);
+}
+
+static il_allocator_t allocator = { libc_alloc, libc_realloc, libc_free, NULL };
+
+// accounting of current parse (per thread)
+static __thread il_mem_stats_t *mem_stats = NULL;
+static __thread il_mem_phase_t mem_phase = IL_MEM_LOAD;
+
+static void mem_account(size_t old_size, size_t size) {
+    il_mem_stats_t *stats = mem_stats;
+
+    if (stats == NULL)
+        return;
+
+    stats->current -= old_size < stats->current ? old_size : stats->current;
+    if (size == 0)
+        return;
+
+    stats->current += size;
+    ++stats->allocs;
+    stats->bytes += size;
+    ++stats->phase[mem_phase].allocs;
+    stats->phase[mem_phase].bytes += size;
+
+    if (stats->current > stats->peak)
+        stats->peak = stats->current;
+    if (stats->current > stats->phase[mem_phase].peak)
+        stats->phase[mem_phase].peak = stats->current;
+}
+
+/////////////////////// strings hooks /////////////////////////
+
+static void* strings_alloc(void *ctx, size_t size) {
+    void *ptr = allocator.alloc(allocator.ctx, size);
+
+    (void) ctx;
+
+    if (ptr != NULL)
+        mem_account(0, size);
+
+    return ptr;
+}
+
+static void* strings_realloc(void *ctx, void *ptr, size_t old_size, size_t size) {
+    void *new = allocator.realloc(allocator.ctx, ptr, old_size, size);
+
+    (void) ctx;
+
+    if (new != NULL)
+        mem_account(ptr == NULL ? 0 : old_size, size);
+
+    return new;
+}
+
+static void strings_free(void *ctx, void *ptr, size_t size) {
+    (void) ctx;
+
+    mem_account(size, 0);
+    allocator.free(allocator.ctx, ptr, size);
+}
+
+static const il_allocator_t strings_hooks = { strings_alloc, strings_realloc, strings_free, NULL };
+
+// memory functions of strings before il_set_allocator installed the hooks
+static string_allocator_t strings_saved;
+static bool strings_installed = false;
+
+///////////////////////////////////////////////////////////////
+
+/**
+ * @fn void il_set_allocator(const il_allocator_t *hooks)
+ * @brief Set memory functions of parser and strings. Must be called before anything is allocated (not thread safe).
+ *        Strings hooks (accounted, with these functions) replace the ones of string_set_allocator until il_set_allocator(NULL)
+ *
+ * @param hooks Memory functions (NULL: libc, previous strings memory functions are restored)
+ */
+void il_set_allocator(const il_allocator_t *hooks) {
+    if (hooks == NULL) {
+        allocator = (il_allocator_t){ libc_alloc, libc_realloc, libc_free, NULL };
+        if (strings_installed)
+            string_set_allocator(&strings_saved);
+        strings_installed = false;
+        return;
+    }
+
+    allocator = *hooks;
+    if (!strings_installed) {
+        strings_saved = *string_get_allocator();
+        string_set_allocator(&strings_hooks);
+        strings_installed = true;
+    }
+}
+
+/**
+ * @fn void* il_malloc(size_t size)
+ * @brief Allocate memory of parser (release with il_free)
+ *
+ * @param size Size
+ * @return Pointer (NULL if out of memory)
+ */
+void* il_malloc(size_t size) {
+    il_mem_header_t *header = allocator.alloc(allocator.ctx, sizeof(il_mem_header_t) + size);
+
+    if (header == NULL)
+        return NULL;
+
+    header->size = size;
+    mem_account(0, size);
+
+    return header + 1;
+}
+
+/**
+ * @fn void* il_calloc(size_t nmemb, size_t size)
+ * @brief Allocate zeroed memory of parser (release with il_free)
+ *
+ * @param nmemb Number of elements
+ * @param size Element size
+ * @return Pointer (NULL if out of memory)
+ */
+void* il_calloc(size_t nmemb, size_t size) {
+    void *ptr = il_malloc(nmemb * size);
+
+    if (ptr != NULL)
+        memset(ptr, 0, nmemb * size);
+
+    return ptr;
+}
+
+/**
+ * @fn void* il_realloc(void *ptr, size_t size)
+ * @brief Resize memory of parser
+ *
+ * @param ptr Block (NULL: new block)
+ * @param size New size
+ * @return Pointer (NULL if out of memory, block is not released)
+ */
+void* il_realloc(void *ptr, size_t size) {
+    il_mem_header_t *header;
+    size_t old_size;
+
+    if (ptr == NULL)
+        return il_malloc(size);
+
+    header = (il_mem_header_t*) ptr - 1;
+    old_size = header->size;
+    if ((header = allocator.realloc(allocator.ctx, header, sizeof(il_mem_header_t) + old_size, sizeof(il_mem_header_t) + size)) == NULL)
+        return NULL;
+
+    header->size = size;
+    mem_account(old_size, size);
+
+    return header + 1;
+}
+
+/**
+ * @fn void il_free(void *ptr)
+ * @brief Release memory of parser
+ *
+ * @param ptr Block (NULL: nothing)
+ */
+void il_free(void *ptr) {
+    il_mem_header_t *header;
+
+    if (ptr == NULL)
+        return;
+
+    header = (il_mem_header_t*) ptr - 1;
+    mem_account(header->size, 0);
+    allocator.free(allocator.ctx, header, sizeof(il_mem_header_t) + header->size);
+}
+
+/**
+ * @fn il_mem_stats_t* il_mem_bind(il_mem_stats_t *stats)
+ * @brief Account next allocations of this thread in stats
+ *
+ * @param stats Stats (NULL: no accounting)
+ * @return Previous stats
+ */
+il_mem_stats_t* il_mem_bind(il_mem_stats_t *stats) {
+    il_mem_stats_t *prev = mem_stats;
+
+    mem_stats = stats;
+
+    return prev;
+}
+
+/**
+ * @fn il_mem_phase_t il_mem_phase(il_mem_phase_t phase)
+ * @brief Phase of next allocations of this thread
+ *
+ * @param phase Phase
+ * @return Previous phase
+ */
+il_mem_phase_t il_mem_phase(il_mem_phase_t phase) {
+    il_mem_phase_t prev = mem_phase;
+
+    mem_phase = phase;
+
+    return prev;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file il_alloc.h
+ * @brief memory hooks and accounting
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef IL_ALLOC_H_
+#define IL_ALLOC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "strings.h"
+
+typedef string_allocator_t il_allocator_t; // same hooks for parser and strings (sizes are the ones of the allocation)
+
+// Strings use the string_set_allocator functions (libc by default) and are not accounted in il_mem_stats_t.
+// il_set_allocator is the opt-in: it saves them and installs hooks that allocate strings with the parser memory
+// functions (and account them) until il_set_allocator(NULL) restores them. Parsing never changes them.
+
+typedef enum MEM_PHASE {
+    IL_MEM_LOAD,     // source, parser and result setup
+    IL_MEM_LEXER,    // comments and multiline substitution
+    IL_MEM_LABELS,   // labels and jumps resolution
+    IL_MEM_LITERALS, // instructions and literals parsing
+    IL_MEM_PHASES    //
+} il_mem_phase_t;
+
+typedef struct il_mem_stats_s {
+    struct {
+        uint64_t allocs;       // allocations (realloc included)
+        uint64_t bytes;        // bytes requested
+        uint64_t peak;         // peak of bytes in use while in phase
+    } phase[IL_MEM_PHASES];    //
+        uint64_t allocs;       // total allocations
+        uint64_t bytes;        // total bytes requested
+        uint64_t current;      // bytes in use
+        uint64_t peak;         // peak of bytes in use
+} il_mem_stats_t;
+
+            void il_set_allocator(const il_allocator_t *allocator);
+           void* il_malloc(size_t size);
+           void* il_calloc(size_t nmemb, size_t size);
+           void* il_realloc(void *ptr, size_t size);
+            void il_free(void *ptr);
+ il_mem_stats_t* il_mem_bind(il_mem_stats_t *stats);
+  il_mem_phase_t il_mem_phase(il_mem_phase_t phase);
+
+#endif /* IL_ALLOC_H_ */
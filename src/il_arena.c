@@ -0,0 +1,184 @@
+/**
+ * @file il_arena.c
+ * @brief parse-scoped bump allocator
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "il_arena.h"
+#include "il_alloc.h"
+
+#define ARENA_ALIGN      8                 // largest alignment of parser data (pointers, double, int64_t)
+#define ARENA_CHUNK_MIN  (4 * 1024)        // first chunk
+#define ARENA_CHUNK_MAX  (1024 * 1024)     // chunks grow up to this size
+#define ALIGN_UP(n)      (((n) + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1))
+
+struct il_arena_chunk_s {
+    il_arena_chunk_t *prev; // previous chunk
+              size_t size;  // data size
+              size_t used;  //
+            uint64_t data[]; // aligned data
+};
+
+static il_arena_chunk_t* chunk_new(il_arena_t *arena, size_t size) {
+    il_arena_chunk_t *chunk = il_malloc(sizeof(il_arena_chunk_t) + size);
+
+    if (chunk == NULL)
+        return NULL;
+
+    chunk->size = size;
+    chunk->used = 0;
+    ++arena->chunks;
+
+    return chunk;
+}
+
+/**
+ * @fn void il_arena_init(il_arena_t *arena)
+ * @brief Initialize arena (first chunk is allocated on first use)
+ *
+ * @param arena Arena
+ */
+void il_arena_init(il_arena_t *arena) {
+    arena->chunk = NULL;
+    arena->last = NULL;
+    arena->chunk_size = ARENA_CHUNK_MIN;
+    arena->chunks = 0;
+    arena->allocated = 0;
+}
+
+/**
+ * @fn void* il_arena_alloc(il_arena_t *arena, size_t size)
+ * @brief Allocate from arena. A NULL arena allocates from heap (il_malloc)
+ *
+ * @param arena Arena
+ * @param size Size
+ * @return Pointer (NULL if out of memory)
+ */
+void* il_arena_alloc(il_arena_t *arena, size_t size) {
+    il_arena_chunk_t *chunk;
+    void *ptr;
+
+    if (arena == NULL)
+        return il_malloc(size);
+
+    size = ALIGN_UP(size);
+    arena->allocated += size;
+
+    // big blocks get their own chunk behind the current one
+    if (size > arena->chunk_size / 4) {
+        if ((chunk = chunk_new(arena, size)) == NULL)
+            return NULL;
+        chunk->used = size;
+        if (arena->chunk == NULL) {
+            chunk->prev = NULL;
+            arena->chunk = chunk;
+        } else {
+            chunk->prev = arena->chunk->prev;
+            arena->chunk->prev = chunk;
+        }
+
+        return chunk->data;
+    }
+
+    if (arena->chunk == NULL || arena->chunk->size - arena->chunk->used < size) {
+        if ((chunk = chunk_new(arena, arena->chunk_size)) == NULL)
+            return NULL;
+        chunk->prev = arena->chunk;
+        arena->chunk = chunk;
+        if (arena->chunk_size < ARENA_CHUNK_MAX)
+            arena->chunk_size *= 2;
+    }
+
+    ptr = (char*) arena->chunk->data + arena->chunk->used;
+    arena->chunk->used += size;
+    arena->last = ptr;
+
+    return ptr;
+}
+
+/**
+ * @fn void* il_arena_realloc(il_arena_t *arena, void *ptr, size_t old_size, size_t size)
+ * @brief Resize an arena block. Last block allocated grows in place when it fits, otherwise it is copied.
+ *        A NULL arena uses heap (il_realloc)
+ *
+ * @param arena Arena
+ * @param ptr Block (NULL: new block)
+ * @param old_size Current size of block
+ * @param size New size
+ * @return Pointer (NULL if out of memory)
+ */
+void* il_arena_realloc(il_arena_t *arena, void *ptr, size_t old_size, size_t size) {
+    il_arena_chunk_t *chunk;
+    void *new;
+
+    if (arena == NULL)
+        return il_realloc(ptr, size);
+
+    if (ptr == NULL)
+        return il_arena_alloc(arena, size);
+
+    chunk = arena->chunk;
+    if (ptr == arena->last) {
+        size_t start = (char*) ptr - (char*) chunk->data;
+
+        if (start + ALIGN_UP(size) <= chunk->size) {
+            arena->allocated += ALIGN_UP(size) - (chunk->used - start);
+            chunk->used = start + ALIGN_UP(size);
+            return ptr;
+        }
+    }
+
+    if (size <= old_size)
+        return ptr;
+
+    if ((new = il_arena_alloc(arena, size)) == NULL)
+        return NULL;
+    memcpy(new, ptr, old_size);
+
+    return new;
+}
+
+/**
+ * @fn void il_arena_free(il_arena_t *arena)
+ * @brief Free all arena blocks (arena can be used again)
+ *
+ * @param arena Arena
+ */
+void il_arena_free(il_arena_t *arena) {
+    il_arena_chunk_t *chunk = arena->chunk, *prev;
+
+    while (chunk != NULL) {
+        prev = chunk->prev;
+        il_free(chunk);
+        chunk = prev;
+    }
+
+    il_arena_init(arena);
+}
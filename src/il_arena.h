@@ -0,0 +1,52 @@
+/**
+ * @file il_arena.h
+ * @brief parse-scoped bump allocator
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef IL_ARENA_H_
+#define IL_ARENA_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct il_arena_chunk_s il_arena_chunk_t;
+
+typedef struct il_arena_s {
+    il_arena_chunk_t *chunk;      // current chunk (linked to previous ones)
+                void *last;       // last allocation (can grow in place)
+              size_t chunk_size;  // size of next chunk
+              size_t chunks;      // number of chunks
+              size_t allocated;   // bytes requested
+} il_arena_t;
+
+ void il_arena_init(il_arena_t *arena);
+void* il_arena_alloc(il_arena_t *arena, size_t size);
+void* il_arena_realloc(il_arena_t *arena, void *ptr, size_t old_size, size_t size);
+ void il_arena_free(il_arena_t *arena);
+
+#endif /* IL_ARENA_H_ */
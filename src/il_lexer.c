@@ -0,0 +1,512 @@
+/**
+ * @file il_lexer.c
+ * @brief single pass lexer for IEC61131-3 IL source
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "il_parser.h"
+#include "il_lexer.h"
+#include "il_alloc.h"
+
+#define IS_SPACE(c)       ((c) == ' ' || (c) == '\t' || (c) == '\r' || (c) == '\v' || (c) == '\f')
+#define IS_IDENT_START(c) (((c) >= 'A' && (c) <= 'Z') || ((c) >= 'a' && (c) <= 'z') || (c) == '_')
+#define IS_IDENT(c)       (IS_IDENT_START(c) || ((c) >= '0' && (c) <= '9'))
+#define TO_UPPER(c)       (((c) >= 'a' && (c) <= 'z') ? (c) - 32 : (c))
+
+enum LEXER_MODE {
+    MODE_PLAIN, // single line instruction
+    MODE_CAL,   // call: continues until parenthesis are balanced
+    MODE_VAR    // variables definition: continues until END_VAR
+};
+
+static const il_str_t commands[] = {
+//  STR_CMD, CODE  , C, N, P
+  { "LD"   , IL_LD , 0, 0, 0 }, // 1
+  { "LDN"  , IL_LD , 0, 1, 0 }, // 2
+  { "ST"   , IL_ST , 0, 0, 0 }, // 3
+  { "STN"  , IL_ST , 0, 1, 0 }, // 4
+  { "S"    , IL_S  , 0, 0, 0 }, // 5
+  { "R"    , IL_R  , 0, 0, 0 }, // 6
+  { "AND"  , IL_AND, 0, 0, 0 }, // 7
+  { "&"    , IL_AND, 0, 0, 0 }, // 8
+  { "ANDN" , IL_AND, 0, 1, 0 }, // 9
+  { "&N"   , IL_AND, 0, 1, 0 }, // 10
+  { "OR"   , IL_OR , 0, 0, 0 }, // 11
+  { "ORN"  , IL_OR , 0, 1, 0 }, // 12
+  { "XOR"  , IL_XOR, 0, 0, 0 }, // 13
+  { "XORN" , IL_XOR, 0, 1, 0 }, // 14
+  { "AND(" , IL_AND, 0, 0, 1 }, // 15
+  { "&("   , IL_AND, 0, 0, 1 }, // 16
+  { "ANDN(", IL_AND, 0, 1, 1 }, // 17
+  { "&N("  , IL_AND, 0, 1, 1 }, // 18
+  { "OR("  , IL_OR , 0, 0, 1 }, // 19
+  { "ORN(" , IL_OR , 0, 1, 1 }, // 20
+  { "XOR(" , IL_XOR, 0, 0, 1 }, // 21
+  { "XORN(", IL_XOR, 0, 1, 1 }, // 22
+  { "ADD"  , IL_ADD, 0, 0, 0 }, // 23
+  { "SUB"  , IL_SUB, 0, 0, 0 }, // 24
+  { "MUL"  , IL_MUL, 0, 0, 0 }, // 25
+  { "DIV"  , IL_DIV, 0, 0, 0 }, // 26
+  { "GT"   , IL_GT , 0, 0, 0 }, // 27
+  { "GE"   , IL_GE , 0, 0, 0 }, // 28
+  { "EQ"   , IL_EQ , 0, 0, 0 }, // 29
+  { "NE"   , IL_NE , 0, 0, 0 }, // 30
+  { "LE"   , IL_LE , 0, 0, 0 }, // 31
+  { "LT"   , IL_LT , 0, 0, 0 }, // 32
+  { "ADD(" , IL_ADD, 0, 0, 1 }, // 33
+  { "SUB(" , IL_SUB, 0, 0, 1 }, // 34
+  { "MUL(" , IL_MUL, 0, 0, 1 }, // 35
+  { "DIV(" , IL_DIV, 0, 0, 1 }, // 36
+  { "GT("  , IL_GT , 0, 0, 1 }, // 37
+  { "GE("  , IL_GE , 0, 0, 1 }, // 38
+  { "EQ("  , IL_EQ , 0, 0, 1 }, // 39
+  { "NE("  , IL_NE , 0, 0, 1 }, // 40
+  { "LE("  , IL_LE , 0, 0, 1 }, // 41
+  { "LT("  , IL_LT , 0, 0, 1 }, // 42
+  { "JMP"  , IL_JMP, 0, 0, 0 }, // 43
+  { "JMPC" , IL_JMP, 1, 0, 0 }, // 44
+  { "JMPCN", IL_JMP, 1, 1, 0 }, // 45
+  { "JMPNC", IL_JMP, 1, 1, 0 }, // 46
+  { "CAL"  , IL_CAL, 0, 0, 0 }, // 47
+  { "CALC" , IL_CAL, 1, 0, 0 }, // 48
+  { "CALCN", IL_CAL, 1, 1, 0 }, // 49
+  { "CALNC", IL_CAL, 1, 1, 0 }, // 50
+  { "RET"  , IL_RET, 0, 0, 0 }, // 51
+  { "RETC" , IL_RET, 1, 0, 0 }, // 52
+  { "RETCN", IL_RET, 1, 1, 0 }, // 53
+  { "RETNC", IL_RET, 1, 1, 0 }, // 54
+  { ")"    , IL_POP, 0, 0, 0 }, // 55
+  { "VAR_OUTPUT"  , IL_VAO, 0, 0, 0 }, // 56
+  { "VAR_INPUT"   , IL_VAI, 0, 0, 0 }, // 57
+  { "VAR"  , IL_VAD, 0, 0, 0 }, // 58
+  { ""     , IL_END, 0, 0, 0 }  // 59
+};
+
+// Perfect hash of commands[] mnemonics: FNV-1a (32 bits) of the upper case
+// mnemonic with seed COMMANDS_HASH_SEED, the top 8 bits index commands_hash[]
+// (position in commands[] + 1, 0 is empty). Seed was searched to be collision
+// free, must be regenerated if commands[] changes.
+#define COMMANDS_HASH_SEED 2633
+#define COMMANDS_MAX_LEN   10
+
+static const uint8_t commands_hash[256] = {
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0, 54,  0,  5,  6,  0, 12,  0, 36,
+     0,  0,  0,  0,  0,  0,  0,  0, 25,  0,  0,  0,  0,  0,  0,  0,
+     0, 52, 50,  0,  0,  0,  0, 19,  0,  0, 34,  0,  0,  0,  0,  0,
+     0,  0, 35,  0,  0,  0,  0,  0,  0, 48,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0, 49,  0,  0, 57,  9,  0,  0,  0, 30,  0,  4,
+    55,  0,  0,  0,  0, 18,  0,  0,  0,  0,  0, 16,  0,  0,  0,  8,
+     0, 28,  2,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    27,  0, 32,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 44, 17,  0,
+     0, 31,  1,  0,  0, 24,  0, 22,  0,  0,  0, 56,  0,  0,  0,  0,
+     0,  0,  0,  0,  0, 40,  0,  0,  0,  0, 11,  0,  0,  0,  0,  0,
+     0, 29, 43,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0,  0,  0,  0,
+    33,  3,  0,  0, 37, 46,  0,  0,  0, 10, 38,  0, 58,  0, 23,  0,
+     0,  0, 47, 39,  0,  0, 41, 13,  0,  0, 45,  0,  0, 21,  0,  0,
+     0, 20,  0, 51,  0, 53,  0,  0,  0,  0,  0,  0, 42,  0,  0,  0,
+    26,  0,  7,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 14
+};
+
+/////////////////////// text buffer ///////////////////////////
+
+static void text_putc(il_lexer_t *lx, char c) {
+    if (lx->text_len + 1 >= lx->text_cap) {
+        lx->text_cap *= 2;
+        lx->text = il_realloc(lx->text, lx->text_cap);
+    }
+
+    lx->text[lx->text_len++] = c;
+}
+
+static void text_puts(il_lexer_t *lx, const char *str) {
+    while (*str)
+        text_putc(lx, *str++);
+}
+
+static void text_end(il_lexer_t *lx) {
+    text_putc(lx, '\0');
+    --lx->text_len;
+}
+
+static void push_token(il_lexer_t *lx, il_token_kind_t kind, uint32_t text, uint32_t src) {
+    il_token_t *tok = &(lx->queue[lx->queue_len++]);
+
+    tok->kind = kind;
+    tok->text = text;
+    tok->len = lx->text_len - text;
+    tok->src = src;
+    tok->line = lx->line;
+    tok->column = src - lx->line_start + 1;
+    tok->cmd = NULL;
+
+    // keep token text null-terminated
+    text_end(lx);
+    if (kind != IL_TK_EOL)
+        ++lx->text_len;
+}
+
+///////////////////////////////////////////////////////////////
+
+//////////////////////// scanning /////////////////////////////
+
+static uint32_t line_end(il_lexer_t *lx, uint32_t pos) {
+    const char *nl = memchr(lx->src + pos, '\n', lx->src_len - pos);
+
+    return nl == NULL ? lx->src_len : nl - lx->src;
+}
+
+static uint32_t next_line(il_lexer_t *lx) {
+    uint32_t eol = line_end(lx, lx->pos);
+
+    ++lx->line;
+    lx->line_start = lx->pos;
+    lx->pos = eol < lx->src_len ? eol + 1 : eol;
+
+    return eol;
+}
+
+static inline void comment_open(il_lexer_t *lx, uint32_t pos) {
+    lx->in_comment = true;
+    lx->comment_line = lx->line;
+    lx->comment_column = pos - lx->line_start + 1;
+}
+
+static uint32_t skip_blank(il_lexer_t *lx, uint32_t pos, uint32_t eol) {
+    const char *src = lx->src;
+
+    while (pos < eol) {
+        if (lx->in_comment) {
+            if (src[pos] == '*' && pos + 1 < eol && src[pos + 1] == ')') {
+                lx->in_comment = false;
+                ++pos;
+            }
+        } else if (src[pos] == '(' && pos + 1 < eol && src[pos + 1] == '*') {
+            comment_open(lx, pos);
+            ++pos;
+        } else if (!IS_SPACE(src[pos]))
+            break;
+
+        ++pos;
+    }
+
+    return pos;
+}
+
+static bool has_end_var(il_lexer_t *lx, uint32_t from) {
+    const char *end_var = "END_VAR";
+
+    for (uint32_t n = from; n + 7 <= lx->text_len; n++) {
+        uint32_t m = 0;
+        while (m < 7 && TO_UPPER(lx->text[n + m]) == end_var[m])
+            ++m;
+        if (m == 7)
+            return true;
+    }
+
+    return false;
+}
+
+/*
+ * Append operand text from src[pos..eol) removing comments, collapsing blanks and rewriting '%' as "PHY#".
+ * On variables definitions ':' becomes '=' and ';' a separator.
+ */
+static void lex_operand(il_lexer_t *lx, uint32_t pos, uint32_t eol, uint32_t start, uint8_t mode, bool blank, int32_t *depth) {
+    const char *src = lx->src;
+    char quote = 0, c;
+
+    for (; pos < eol; pos++) {
+        c = src[pos];
+
+        if (lx->in_comment) {
+            if (c == '*' && pos + 1 < eol && src[pos + 1] == ')') {
+                lx->in_comment = false;
+                blank = true;
+                ++pos;
+            }
+            continue;
+        }
+
+        if (quote) {
+            text_putc(lx, c);
+            if (c == '$' && pos + 1 < eol)
+                text_putc(lx, src[++pos]);
+            else if (c == quote)
+                quote = 0;
+            continue;
+        }
+
+        if (c == '(' && pos + 1 < eol && src[pos + 1] == '*') {
+            comment_open(lx, pos);
+            ++pos;
+            continue;
+        }
+
+        if (c == ';') {
+            if (mode != MODE_VAR)
+                break;
+            blank = true;
+            continue;
+        }
+
+        if (IS_SPACE(c)) {
+            blank = true;
+            continue;
+        }
+
+        if (mode == MODE_VAR) {
+            if (c == ':')
+                c = '=';
+            if (c == '=' || c == ',') {
+                text_putc(lx, c);
+                blank = false;
+                continue;
+            }
+        }
+
+        if (blank && lx->text_len > start
+                && !(mode == MODE_VAR && (lx->text[lx->text_len - 1] == '=' || lx->text[lx->text_len - 1] == ',')))
+            text_putc(lx, ' ');
+        blank = false;
+
+        switch (c) {
+            case '\'':
+            case '"':
+                quote = c;
+                break;
+            case '%':
+                text_puts(lx, "PHY#");
+                continue;
+            case '(':
+                ++(*depth);
+                break;
+            case ')':
+                --(*depth);
+                break;
+        }
+
+        text_putc(lx, c);
+    }
+
+    text_end(lx);
+}
+
+static bool lex_instruction(il_lexer_t *lx) {
+    const char *src = lx->src;
+    const il_str_t *cmd;
+    uint32_t pos, eol, tmp, text;
+    uint8_t mode;
+    int32_t depth = 0;
+
+    while (lx->pos < lx->src_len) {
+        pos = lx->pos;
+        eol = next_line(lx);
+
+        if ((pos = skip_blank(lx, pos, eol)) == eol || src[pos] == ';')
+            continue;
+
+        // label
+        if (IS_IDENT_START(src[pos])) {
+            tmp = pos;
+            while (tmp < eol && IS_IDENT(src[tmp]))
+                ++tmp;
+
+            if (tmp < eol && src[tmp] == ':' && (tmp + 1 == eol || IS_SPACE(src[tmp + 1]) || src[tmp + 1] == ';')) {
+                text = lx->text_len;
+                for (uint32_t n = pos; n < tmp; n++)
+                    text_putc(lx, src[n]);
+                push_token(lx, IL_TK_LABEL, text, pos);
+
+                // a label alone is for next instruction
+                if ((pos = skip_blank(lx, tmp + 1, eol)) == eol || src[pos] == ';')
+                    return true;
+            }
+        }
+
+        // opcode
+        text = lx->text_len;
+        for (tmp = pos; tmp < eol && !IS_SPACE(src[tmp]) && src[tmp] != ';'; tmp++)
+            text_putc(lx, TO_UPPER(src[tmp]));
+
+        cmd = il_lexer_command(src + pos, tmp - pos);
+        push_token(lx, IL_TK_OPCODE, text, pos);
+        lx->queue[lx->queue_len - 1].cmd = cmd;
+
+        mode = MODE_PLAIN;
+        if (cmd == NULL || cmd->code == IL_CAL)
+            mode = MODE_CAL;
+        else if (cmd->code == IL_VAD || cmd->code == IL_VAI || cmd->code == IL_VAO)
+            mode = MODE_VAR;
+
+        // operand
+        pos = skip_blank(lx, tmp, eol);
+        text = lx->text_len;
+        lex_operand(lx, pos, eol, text, mode, false, &depth);
+
+        //// cal/var expanded format ////
+        if ((mode == MODE_CAL && depth > 0) || (mode == MODE_VAR && !has_end_var(lx, text))) {
+            il_expansion_t exp = {
+                    .state = IL_EXP_START,
+                    .format = mode == MODE_CAL ? LIT_CAL : LIT_VAD,
+                    .opcode = lx->text + lx->queue[lx->queue_len - 1].text,
+                    .text = lx->text + text,
+                    .len = lx->text_len - text,
+                    .line = lx->line
+            };
+            IL_EMIT(lx->listener, expansion, &exp);
+
+            while (lx->pos < lx->src_len) {
+                uint32_t seg = lx->text_len, start = lx->pos;
+
+                eol = next_line(lx);
+                if ((start = skip_blank(lx, start, eol)) == eol || (src[start] == ';' && mode != MODE_VAR))
+                    continue;
+
+                lex_operand(lx, start, eol, text, mode, true, &depth);
+                if (lx->listener != NULL) {
+                    uint32_t from = seg + (seg < lx->text_len && lx->text[seg] == ' ');
+
+                    // text buffer can be moved when growing
+                    exp.state = IL_EXP_LINE;
+                    exp.opcode = lx->text + lx->queue[lx->queue_len - 1].text;
+                    exp.text = lx->text + from;
+                    exp.len = lx->text_len - from;
+                    exp.line = lx->line;
+                    IL_EMIT(lx->listener, expansion, &exp);
+                }
+
+                if ((mode == MODE_CAL && depth <= 0) || (mode == MODE_VAR && has_end_var(lx, seg))) {
+                    mode = MODE_PLAIN;
+                    break;
+                }
+            }
+
+            exp.state = IL_EXP_END;
+            exp.opcode = lx->text + lx->queue[lx->queue_len - 1].text;
+            exp.text = NULL;
+            exp.len = 0;
+            IL_EMIT(lx->listener, expansion, &exp);
+
+            // opcode token becomes the error, text is the operand read
+            if (mode != MODE_PLAIN) {
+                lx->error = mode == MODE_CAL ? "unfinished call" : "unfinished variables definition";
+                lx->queue[lx->queue_len - 1].kind = IL_TK_ERROR;
+                lx->queue[lx->queue_len - 1].text = text;
+                lx->queue[lx->queue_len - 1].len = lx->text_len - text;
+                lx->queue[lx->queue_len - 1].cmd = NULL;
+                push_token(lx, IL_TK_EOL, lx->text_len, eol);
+
+                return true;
+            }
+        }
+        /////////////////////////
+
+        if (lx->text_len > text)
+            push_token(lx, IL_TK_OPERAND, text, pos);
+        push_token(lx, IL_TK_EOL, lx->text_len, eol);
+
+        return true;
+    }
+
+    if (lx->in_comment) {
+        lx->in_comment = false;
+        lx->error = "unfinished comment";
+        push_token(lx, IL_TK_ERROR, lx->text_len, lx->src_len);
+        lx->queue[lx->queue_len - 1].line = lx->comment_line;
+        lx->queue[lx->queue_len - 1].column = lx->comment_column;
+
+        return true;
+    }
+
+    return false;
+}
+
+///////////////////////////////////////////////////////////////
+
+void il_lexer_init(il_lexer_t *lx, const char *src, uint32_t len) {
+    lx->src = src;
+    lx->src_len = len;
+    lx->pos = 0;
+    lx->line = 0;
+    lx->line_start = 0;
+    lx->in_comment = false;
+    lx->comment_line = 0;
+    lx->comment_column = 0;
+    lx->error = NULL;
+    lx->listener = NULL;
+    lx->text_cap = 256;
+    lx->text = il_malloc(lx->text_cap);
+    lx->text_len = 0;
+    lx->queue_len = 0;
+    lx->queue_pos = 0;
+}
+
+bool il_lexer_next(il_lexer_t *lx, il_token_t *tok) {
+    if (lx->queue_pos == lx->queue_len) {
+        lx->queue_len = lx->queue_pos = 0;
+        lx->text_len = 0;
+        if (!lex_instruction(lx))
+            return false;
+    }
+
+    *tok = lx->queue[lx->queue_pos++];
+
+    return true;
+}
+
+void il_lexer_free(il_lexer_t *lx) {
+    il_free(lx->text);
+    lx->text = NULL;
+    lx->text_len = lx->text_cap = 0;
+}
+
+const il_str_t* il_lexer_command(const char *mnemonic, uint32_t len) {
+    const il_str_t *cmd;
+    uint32_t hash = COMMANDS_HASH_SEED;
+    uint32_t n;
+
+    if (len == 0 || len > COMMANDS_MAX_LEN)
+        return NULL;
+
+    for (n = 0; n < len; n++)
+        hash = (hash ^ (uint8_t) TO_UPPER(mnemonic[n])) * 16777619u;
+
+    if ((n = commands_hash[hash >> 24]) == 0)
+        return NULL;
+
+    cmd = &commands[n - 1];
+    for (n = 0; n < len; n++) {
+        if (TO_UPPER(mnemonic[n]) != cmd->str[n])
+            return NULL;
+    }
+
+    return cmd->str[len] == '\0' ? cmd : NULL;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file il_lexer.h
+ * @brief single pass lexer for IEC61131-3 IL source
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef IL_LEXER_H_
+#define IL_LEXER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "il_parser.h"
+
+typedef struct il_str_s {
+    const char *str; //
+       uint8_t code; //
+          bool c;    // conditional
+          bool n;    // negate
+          bool p;    // push '('
+} il_str_t;
+
+typedef enum TOKEN_KIND {
+    IL_TK_LABEL,   // label definition (without ':')
+    IL_TK_OPCODE,  // instruction mnemonic (upper case)
+    IL_TK_OPERAND, // operand (comments removed, continuation lines joined, '%' as "PHY#")
+    IL_TK_EOL,     // end of instruction
+    IL_TK_ERROR    // lexical error (message in lexer error, text is the offending source)
+} il_token_kind_t;
+
+typedef struct il_token_s {
+    il_token_kind_t kind;   //
+           uint32_t text;   // offset of normalized text in lexer text buffer
+           uint32_t len;    // length of normalized text
+           uint32_t src;    // offset in source buffer
+           uint32_t line;   // source line (start in 1)
+           uint32_t column; // source column (start in 1)
+     const il_str_t *cmd;   // recognized command of IL_TK_OPCODE (NULL: implicit call)
+} il_token_t;
+
+typedef struct il_view_s {
+        char *ptr; // not null-terminated
+    uint32_t len;  //
+} il_view_t;
+
+typedef struct il_lexer_s {
+             const char *src;           // source buffer
+               uint32_t src_len;        // source length
+               uint32_t pos;            // start of next source line
+               uint32_t line;           // current source line
+               uint32_t line_start;     // offset of current source line
+                   bool in_comment;     // inside a (* *) comment
+               uint32_t comment_line;   // start of current comment
+               uint32_t comment_column; //
+             const char *error;         // message of last IL_TK_ERROR token
+    const il_listener_t *listener;      // expansion events
+                   char *text;          // normalized text of current instruction tokens (each one null-terminated)
+               uint32_t text_len;       //
+               uint32_t text_cap;       //
+             il_token_t queue[4];       // tokens of current instruction
+                uint8_t queue_len;      //
+                uint8_t queue_pos;      //
+} il_lexer_t;
+
+/**
+ * @def IL_EMIT
+ * @brief Call listener event if installed
+ *
+ */
+#define IL_EMIT(listener, event, ...)                                   \
+    do {                                                                \
+        if ((listener) != NULL && (listener)->event != NULL)            \
+            (listener)->event((listener)->ctx, __VA_ARGS__);            \
+    } while (0)
+
+/**
+ * @def il_lexer_text
+ * @brief Normalized text of a token (valid until next instruction is lexed)
+ *
+ */
+#define il_lexer_text(lx, tok) ((lx)->text + (tok)->text)
+
+/**
+ * @def il_lexer_view
+ * @brief View of token normalized text
+ *
+ */
+#define il_lexer_view(lx, tok) ((il_view_t){ (lx)->text + (tok)->text, (tok)->len })
+
+           void il_lexer_init(il_lexer_t *lx, const char *src, uint32_t len);
+           bool il_lexer_next(il_lexer_t *lx, il_token_t *tok);
+           void il_lexer_free(il_lexer_t *lx);
+const il_str_t* il_lexer_command(const char *mnemonic, uint32_t len);
+
+#endif /* IL_LEXER_H_ */
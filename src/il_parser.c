@@ -31,86 +31,53 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
+#include <errno.h>
+#include <float.h>
+#include <limits.h>
 #include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "il_parser.h"
+#include "il_lexer.h"
+#include "il_arena.h"
+#include "il_alloc.h"
 #include "strings.h"
 
-typedef struct il_str_s {
-    const char *str; //
-       uint8_t code; //
-          bool c;    // conditional
-          bool n;    // negate
-          bool p;    // push '('
-} il_str_t;
-
 typedef struct il_label_s {
-    String label; //
-    uint32_t line;   //
+      String label;   // label name
+    uint32_t hash;    //
+    uint32_t line;    // instruction index (STR_ERROR: used by a jump, not yet defined)
+    uint32_t pending; // first jump waiting for definition (position in pending + 1, 0 is none)
+    uint32_t last;    // last one of them
 } il_label_t;
 
-static const il_str_t commands[] = {
-//  STR_CMD, CODE  , C, N, P
-  { "LD"   , IL_LD , 0, 0, 0 }, // 1
-  { "LDN"  , IL_LD , 0, 1, 0 }, // 2
-  { "ST"   , IL_ST , 0, 0, 0 }, // 3
-  { "STN"  , IL_ST , 0, 1, 0 }, // 4
-  { "S"    , IL_S  , 0, 0, 0 }, // 5
-  { "R"    , IL_R  , 0, 0, 0 }, // 6
-  { "AND"  , IL_AND, 0, 0, 0 }, // 7
-  { "&"    , IL_AND, 0, 0, 0 }, // 8
-  { "ANDN" , IL_AND, 0, 1, 0 }, // 9
-  { "&N"   , IL_AND, 0, 1, 0 }, // 10
-  { "OR"   , IL_OR , 0, 0, 0 }, // 11
-  { "ORN"  , IL_OR , 0, 1, 0 }, // 12
-  { "XOR"  , IL_XOR, 0, 0, 0 }, // 13
-  { "XORN" , IL_XOR, 0, 1, 0 }, // 14
-  { "AND(" , IL_AND, 0, 0, 1 }, // 15
-  { "&("   , IL_AND, 0, 0, 1 }, // 16
-  { "ANDN(", IL_AND, 0, 1, 1 }, // 17
-  { "&N("  , IL_AND, 0, 1, 1 }, // 18
-  { "OR("  , IL_OR , 0, 0, 1 }, // 19
-  { "ORN(" , IL_OR , 0, 1, 1 }, // 20
-  { "XOR(" , IL_XOR, 0, 0, 1 }, // 21
-  { "XORN(", IL_XOR, 0, 1, 1 }, // 22
-  { "ADD"  , IL_ADD, 0, 0, 0 }, // 23
-  { "SUB"  , IL_SUB, 0, 0, 0 }, // 24
-  { "MUL"  , IL_MUL, 0, 0, 0 }, // 25
-  { "DIV"  , IL_DIV, 0, 0, 0 }, // 26
-  { "GT"   , IL_GT , 0, 0, 0 }, // 27
-  { "GE"   , IL_GE , 0, 0, 0 }, // 28
-  { "EQ"   , IL_EQ , 0, 0, 0 }, // 29
-  { "NE"   , IL_NE , 0, 0, 0 }, // 30
-  { "LE"   , IL_LE , 0, 0, 0 }, // 31
-  { "LT"   , IL_LT , 0, 0, 0 }, // 32
-  { "ADD(" , IL_ADD, 0, 0, 1 }, // 33
-  { "SUB(" , IL_SUB, 0, 0, 1 }, // 34
-  { "MUL(" , IL_MUL, 0, 0, 1 }, // 35
-  { "DIV(" , IL_DIV, 0, 0, 1 }, // 36
-  { "GT("  , IL_GT , 0, 0, 1 }, // 37
-  { "GE("  , IL_GE , 0, 0, 1 }, // 38
-  { "EQ("  , IL_EQ , 0, 0, 1 }, // 39
-  { "NE("  , IL_NE , 0, 0, 1 }, // 40
-  { "LE("  , IL_LE , 0, 0, 1 }, // 41
-  { "LT("  , IL_LT , 0, 0, 1 }, // 42
-  { "JMP"  , IL_JMP, 0, 0, 0 }, // 43
-  { "JMPC" , IL_JMP, 1, 0, 0 }, // 44
-  { "JMPCN", IL_JMP, 1, 1, 0 }, // 45
-  { "JMPNC", IL_JMP, 1, 1, 0 }, // 46
-  { "CAL"  , IL_CAL, 0, 0, 0 }, // 47
-  { "CALC" , IL_CAL, 1, 0, 0 }, // 48
-  { "CALCN", IL_CAL, 1, 1, 0 }, // 49
-  { "CALNC", IL_CAL, 1, 1, 0 }, // 50
-  { "RET"  , IL_RET, 0, 0, 0 }, // 51
-  { "RETC" , IL_RET, 1, 0, 0 }, // 52
-  { "RETCN", IL_RET, 1, 1, 0 }, // 53
-  { "RETNC", IL_RET, 1, 1, 0 }, // 54
-  { ")"    , IL_POP, 0, 0, 0 }, // 55
-  { "VAR_OUTPUT"  , IL_VAO, 0, 0, 0 }, // 56
-  { "VAR"  , IL_VAD, 0, 0, 0 }, // 57
-  { ""     , IL_END, 0, 0, 0 }  // 58
-};
+typedef struct il_labels_s {
+    il_label_t *label; // labels in definition order
+      uint32_t *index; // hash table (position in label + 1, 0 is empty)
+      uint32_t qty;    //
+      uint32_t cap;    // hash table size (power of 2)
+} il_labels_t;
+
+typedef struct il_fixup_s {
+    uint32_t label;      // label used before its definition (position in labels)
+    uint32_t next;       // next jump to same label (position in pending + 1, 0 is none)
+    uint32_t line;       // instruction to fix (jmp_addr)
+    uint32_t src_line;   // position of label in source
+    uint32_t src_column; //
+} il_fixup_t;
+
+typedef struct il_jump_s {
+    uint32_t line;     // instruction index of jump
+    uint32_t jmp_addr; // resolved address
+} il_jump_t;
+
+typedef struct il_error_s {
+    const char *message; // NULL: no error
+     il_view_t value;    // offending text
+} il_error_t;
 
 static const char *il_commands_str[] = {
         "NOP", // 0x00
@@ -140,7 +107,7 @@ static const char *il_commands_str[] = {
         "???", // 0x18
         "???", // 0x19
         "???", // 0x1a
-        "???", // 0x1b
+        "VAI", // 0x1b
         "VAO", // 0x1c
         "VAD", // 0x1d
         "CAL", // 0x1e
@@ -200,6 +167,22 @@ static const uint8_t literal_format[]= {
     LIT_PHY,           // 12
 };
 
+static const uint8_t literal_type[]= {
+    IEC_T_NULL,        // 0
+    IEC_T_BOOL,        // 1
+    IEC_T_NULL,        // 2
+    IEC_T_NULL,        // 3
+    IEC_T_TOD,         // 4
+    IEC_T_DT,          // 5
+    IEC_T_DATE,        // 6
+    IEC_T_TOD,         // 7
+    IEC_T_TIME,        // 8
+    IEC_T_DT,          // 9
+    IEC_T_TIME,        // 10
+    IEC_T_DATE,        // 11
+    IEC_T_PHY,         // 12
+};
+
 static const char *pfx_iectype[] = {
     "NULL#",    // 0
     "BOOL#",    //
@@ -235,6 +218,49 @@ static const char *pfx_iectype[] = {
     "PHY#"      // 31
 };
 
+static const char *var_section_str[] = {
+    "LOCAL",  // IL_VAR_LOCAL
+    "INPUT",  // IL_VAR_INPUT
+    "OUTPUT", // IL_VAR_OUTPUT
+};
+
+// declaration types: natural storage to lay out variables (not the parser representation of literals)
+static const struct {
+    const char *name;   //
+       uint8_t datatype; // il_datatype_t
+       uint8_t size;     // bytes (0: defined by runtime)
+       uint8_t align;    // bytes (0: defined by runtime)
+} var_types[] = {
+    { "BOOL"         , IEC_T_BOOL   , 1, 1 },
+    { "SINT"         , IEC_T_SINT   , 1, 1 },
+    { "USINT"        , IEC_T_USINT  , 1, 1 },
+    { "BYTE"         , IEC_T_BYTE   , 1, 1 },
+    { "UINT"         , IEC_T_UINT   , 2, 2 },
+    { "INT"          , IEC_T_INT    , 2, 2 },
+    { "WORD"         , IEC_T_WORD   , 2, 2 },
+    { "DINT"         , IEC_T_DINT   , 4, 4 },
+    { "UDINT"        , IEC_T_UDINT  , 4, 4 },
+    { "DWORD"        , IEC_T_DWORD  , 4, 4 },
+    { "LINT"         , IEC_T_LINT   , 8, 8 },
+    { "ULINT"        , IEC_T_ULINT  , 8, 8 },
+    { "LWORD"        , IEC_T_LWORD  , 8, 8 },
+    { "REAL"         , IEC_T_REAL   , 4, 4 },
+    { "LREAL"        , IEC_T_LREAL  , 8, 8 },
+    { "TIME"         , IEC_T_TIME   , 4, 4 }, // int32_t msec
+    { "DATE"         , IEC_T_DATE   , 4, 4 }, // uint32_t days
+    { "TIME_OF_DAY"  , IEC_T_TOD    , 4, 4 }, // uint32_t msec of day
+    { "TOD"          , IEC_T_TOD    , 4, 4 }, //
+    { "DATE_AND_TIME", IEC_T_DT     , 8, 8 }, // uint64_t msec
+    { "DT"           , IEC_T_DT     , 8, 8 }, //
+    { "CHAR"         , IEC_T_CHAR   , 1, 1 },
+    { "WCHAR"        , IEC_T_WCHAR  , 2, 2 },
+    { "STRING"       , IEC_T_STRING , 0, 0 },
+    { "WSTRING"      , IEC_T_WSTRING, 0, 0 },
+    { "TON"          , IEC_T_TIMER  , 0, 0 }, // function block instance
+    { "TOF"          , IEC_T_TIMER  , 0, 0 }, //
+    { "TP"           , IEC_T_TIMER  , 0, 0 }, //
+};
+
 static const char phy_prefix_c[] = {
     'I', //
     'Q', //
@@ -248,327 +274,661 @@ static const char phy_data_type_c[] = {
     'D', //
 };
 
-void parse_command(String line, il_t **result);
+/////////////////////// load functions ////////////////////////
 
-/////////////// load and conditioning functions ///////////////
+// map file read only (an empty file is not mapped), NULL on error
+static const char* map_file(char *file, size_t *len) {
+    struct stat st;
+    void *src;
+    int fd;
 
-static int find_labels(il_label_t **il_labels, String **program, int program_lines) {
-    uint32_t index, pos = 0, labels_qty = 0;
+    if ((fd = open(file, O_RDONLY)) == -1)
+        return NULL;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return NULL;
+    }
 
-    *il_labels = calloc(1, sizeof(il_label_t));
+    *len = st.st_size;
+    if (*len == 0) {
+        close(fd);
+        return "";
+    }
 
-    DBG_PRINT("[LABELS]\n");
-    for (uint32_t pc = 0; pc < program_lines; pc++) {
-        if ((index = string_find_c((*program)[pc], ":", 0)) == STR_ERROR)
-            continue;
+    src = mmap(NULL, *len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (src == MAP_FAILED)
+        return NULL;
+    madvise(src, *len, MADV_SEQUENTIAL);
 
-        if (index == (*program)[pc]->length - 1) {
-            printf("ERROR: label alone! [%s]\n", (*program)[pc]->data);
-            exit(1);
-        }
+    return src;
+}
 
-        if ((*program)[pc]->data[index + 1] != ' ')
-            continue;
-        *il_labels = realloc(*il_labels, (pos + 1) * sizeof(il_label_t));
+///////////////////////////////////////////////////////////////
+
+//////////////////////////// views ////////////////////////////
 
-        (*il_labels)[pos].label = string_left((*program)[pc], index - 1);
-        (*il_labels)[pos].line = pc;
+#define VIEW_FMT     "%.*s"
+#define VIEW_ARG(v)  (int)(v).len, (v).ptr
+#define TO_UPPER(c)  (((c) >= 'a' && (c) <= 'z') ? (c) - 32 : (c))
 
-        DBG_PRINT("    [%s line: %d]\n", (*il_labels)[pos].label->data, (*il_labels)[pos].line);
+static inline il_view_t view_left(il_view_t v, uint32_t len) {
+    if (len < v.len)
+        v.len = len;
 
-        string_delete_m((*program)[pc], 0, index);
-        string_trim_m((*program)[pc]);
+    return v;
+}
+
+static inline il_view_t view_right(il_view_t v, uint32_t pos) {
+    if (pos > v.len)
+        pos = v.len;
+    v.ptr += pos;
+    v.len -= pos;
+
+    return v;
+}
+
+static il_view_t view_trim(il_view_t v) {
+    v.len = string_memrtrim(v.ptr, v.len);
+
+    return view_right(v, string_memltrim(v.ptr, v.len));
+}
+
+// search must be upper case, letters of view are compared in upper case
+static uint32_t view_find(il_view_t v, const char *search) {
+    uint32_t len = strlen(search), m;
 
-        ++pos;
-        ++labels_qty;
+    // without letters there is nothing to fold
+    for (m = 0; m < len && !(search[m] >= 'A' && search[m] <= 'Z'); m++)
+        ;
+    if (m == len)
+        return string_memfind(v.ptr, v.len, search, len);
+
+    for (uint32_t n = 0; n + len <= v.len; n++) {
+        for (m = 0; m < len && TO_UPPER(v.ptr[n + m]) == search[m]; m++)
+            ;
+        if (m == len)
+            return n;
     }
 
-    if(labels_qty == 0)
-        DBG_PRINT("    [NONE]\n");
-    DBG_PRINT("\n");
+    return STR_ERROR;
+}
+
+// find character outside of quoted strings
+static uint32_t view_find_unquoted(il_view_t v, char c) {
+    char quote = 0;
+
+    for (uint32_t n = 0; n < v.len; n++) {
+        if (quote) {
+            if (v.ptr[n] == quote)
+                quote = 0;
+        } else if (v.ptr[n] == '\'' || v.ptr[n] == '"')
+            quote = v.ptr[n];
+        else if (v.ptr[n] == c)
+            return n;
+    }
 
-    return labels_qty;
+    return STR_ERROR;
 }
 
-static void delete_comments(String **program, int program_lines) {
-    uint32_t index1 = 0, index2 = 0;
+// count characters outside of quoted strings
+static uint32_t view_count_unquoted(il_view_t v, char c) {
+    uint32_t count = 0;
+    char quote = 0;
+
+    for (uint32_t n = 0; n < v.len; n++) {
+        if (quote) {
+            if (v.ptr[n] == quote)
+                quote = 0;
+        } else if (v.ptr[n] == '\'' || v.ptr[n] == '"')
+            quote = v.ptr[n];
+        else if (v.ptr[n] == c)
+            ++count;
+    }
 
-    for (uint32_t pc = 0; pc < program_lines; pc++) {
-        if ((index1 = string_find_c((*program)[pc], ";", 0)) != STR_ERROR) {
-            string_delete_m((*program)[pc], index1, (*program)[pc]->length);
-        }
+    return count;
+}
 
-        while((index1 = string_find_c((*program)[pc], "(*", 0)) != STR_ERROR) {
-            if((index2 = string_find_c((*program)[pc], "*)", 0)) == STR_ERROR){
-                printf("ERROR: unfinished comment! [%s]\n", (*program)[pc]->data);
-                exit(1);
-            }
+static bool view_equals(il_view_t v, const char *str) {
+    return strlen(str) == v.len && !memcmp(v.ptr, str, v.len);
+}
 
-            string_delete_m((*program)[pc], index1, index2 + 1);
-        }
+static bool view_equals_nocase(il_view_t v, const char *str) {
+    return strlen(str) == v.len && !string_memcasecmp(v.ptr, str, v.len);
+}
+
+static void view_toupper(il_view_t v) {
+    string_memupper(v.ptr, v.ptr, v.len);
+}
+
+static il_view_t view_delete_c(il_view_t v, char c) {
+    uint32_t len = 0;
 
-        string_trim_m((*program)[pc]);
+    for (uint32_t n = 0; n < v.len; n++) {
+        if (v.ptr[n] != c)
+            v.ptr[len++] = v.ptr[n];
     }
+    v.len = len;
+
+    return v;
 }
 
-static void sustitute_labels(il_label_t **il_labels, int labels_qty, String **program, int program_lines) {
-    uint32_t index = 0;
-    char buffer[16];
+static inline bool view_issigned(il_view_t v) {
+    return v.len > 0 && v.ptr[0] == '-';
+}
 
-    for (int pc = 0; pc < program_lines; pc++) {
-        String left = string_left((*program)[pc], string_find_c((*program)[pc], " ", 0) - 1);
-        string_toupper_m(left);
-        if (
-                !string_equals_c((*program)[pc], "JMP")   ||
-                !string_equals_c((*program)[pc], "JMPC")  ||
-                !string_equals_c((*program)[pc], "JMPCN") ||
-                !string_equals_c((*program)[pc], "JMPNC")
-        ) {
-            for (uint32_t lbl = 0; lbl < labels_qty; lbl++) {
-                String right = string_right((*program)[pc], string_find_c((*program)[pc], " ", 0) + 1);
-                if (string_equals(right, (*il_labels)[lbl].label)) {
-                    index = string_find((*program)[pc], (*il_labels)[lbl].label, 0);
-                    sprintf(buffer, "%d", (*il_labels)[lbl].line);
-                    string_replace_c_m((*program)[pc], (*il_labels)[lbl].label->data, buffer, index);
-                }
+// NULL arena: heap (free)
+static String view_string(il_arena_t *arena, il_view_t v) {
+    String str;
 
-                free(right);
-            }
-        }
-        free(left);
-    }
-}
-
-static void sustitute_others(String **program, int program_lines) {
-    for (uint32_t pc = 0; pc < program_lines; pc++) {
-        uint32_t spc = string_find_c((*program)[pc], " ", 0);
-        String left = string_left((*program)[pc], spc - 1);
-        String right = string_right((*program)[pc], spc + 1);
-        // opcodes to upper
-        string_toupper_m(left);
-
-        // physical address
-        string_replace_c_m(right, "%", "PHY#", 0);
-
-        //end
-        string_reset((*program)[pc]);
-        String sp = string_new_c(" ");
-        string_move(&(*program)[pc], &left);
-        string_concat_m((*program)[pc], sp);
-        string_concat_m((*program)[pc], right);
-        free(sp);
-        free(right);
-    }
-}
-
-static int load_file(char *file, String **program) {
-    FILE *f;
-    uint32_t lines = 0;
-    uint32_t ppos;
-    char *line_buf = NULL;
-    size_t line_buf_size = 0;
-    size_t line_size;
-    String linebf, expanded = NULL;
-    bool is_expanded = false;
-    bool is_var = false;
-    il_t *il_tmp = malloc(sizeof(il_t));
-    String spc = string_new_c(" ");
-
-    f = fopen(file, "r");
-    if (f == NULL) {
-        DBG_PRINT("Error: can't open file\n");
-        exit(1);
-    }
-    printf("[FILE: %s]\n\n", file);
-    *program = malloc(sizeof(String));
-
-    while ((line_size = getline(&line_buf, &line_buf_size, f) >= 0)) {
-        linebf = string_new_c(line_buf);
-        if (string_isblank(linebf)) {
-            free (linebf);
+    if (arena == NULL)
+        str = string_new(v.len);
+    else {
+        str = il_arena_alloc(arena, sizeof(string_t) + v.len + 1);
+        str->capacity = v.len | STRING_INLINE; // arena owned
+    }
+
+    memcpy(str->data, v.ptr, v.len);
+    str->data[v.len] = '\0';
+    str->length = v.len;
+
+    return str;
+}
+
+///////////////////////////////////////////////////////////////
+
+/////////////////////////// numbers ///////////////////////////
+
+typedef struct il_number_s {
+    il_dataformat_t format;   // LIT_INTEGER, LIT_REAL or LIT_REAL_EXP (LIT_NONE: illegal)
+               bool negative; // - sign
+               bool range;    // out of range (integer over 64 bits, real overflow or underflow)
+           uint64_t integer;  // integer magnitude
+             double real;     // real value
+} il_number_t;
+
+// powers of ten exact in a double (Clinger fast path)
+static const double pow10_exact[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// range of integer literals by iec type (other types: 64 bits)
+static const struct {
+     int64_t min;
+    uint64_t max;
+} integer_range[] = {
+    [IEC_T_BOOL]  = { 0, 1 },
+    [IEC_T_SINT]  = { INT8_MIN, INT8_MAX },
+    [IEC_T_USINT] = { 0, UINT8_MAX },
+    [IEC_T_BYTE]  = { 0, UINT8_MAX },
+    [IEC_T_UINT]  = { 0, UINT16_MAX },
+    [IEC_T_INT]   = { INT16_MIN, INT16_MAX },
+    [IEC_T_WORD]  = { 0, UINT16_MAX },
+    [IEC_T_DINT]  = { INT32_MIN, INT32_MAX },
+    [IEC_T_UDINT] = { 0, UINT32_MAX },
+    [IEC_T_DWORD] = { 0, UINT32_MAX },
+    [IEC_T_LINT]  = { INT64_MIN, INT64_MAX },
+    [IEC_T_ULINT] = { 0, UINT64_MAX },
+    [IEC_T_LWORD] = { 0, UINT64_MAX },
+};
+
+static inline uint8_t digit_value(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    c |= 0x20;
+    if (c >= 'a' && c <= 'z')
+        return c - 'a' + 10;
+
+    return UINT8_MAX;
+}
+
+// digits of base from n, '_' only between digits. Returns position after last digit
+static uint32_t scan_digits(il_view_t v, uint32_t n, uint8_t base, uint64_t *value, uint32_t *count, bool *overflow) {
+    uint64_t acc = *value;
+    uint32_t digits = 0;
+    uint8_t d;
+
+    for (; n < v.len; n++) {
+        if (v.ptr[n] == '_' && digits > 0 && n + 1 < v.len && digit_value(v.ptr[n + 1]) < base)
             continue;
-        }
-        string_trim_m(linebf);
+        if ((d = digit_value(v.ptr[n])) >= base)
+            break;
+        // under 2^58 no base can overflow
+        if (acc < (1ULL << 58))
+            acc = acc * base + d;
+        else if (__builtin_mul_overflow(acc, base, &acc) || __builtin_add_overflow(acc, d, &acc))
+            *overflow = true;
+        ++digits;
+    }
 
-        // modify VAR
-        if (((ppos = string_find_c(linebf, "VAR", 0)) != STR_ERROR || (ppos = string_find_c(linebf, "VAR_OUTPUT", 0)) != STR_ERROR) && ppos == 0) {
-            string_replace_c_m(linebf, ":", " = ", 0);
-            string_replace_c_m(linebf, ";", " ", 0);
-        }
+    *value = acc;
+    *count = digits;
 
-        //// cal/var expanded format ////
+    return n;
+}
 
-        if (!is_expanded) {
-            String tmp = string_new_c(linebf->data);
+// real out of fast path: strtod of value without separators
+static void number_strtod(il_view_t v, il_number_t *num) {
+    char buffer[64];
+    uint32_t len = 0;
 
-            string_toupper_m(tmp);
-            string_trim_m(tmp);
+    for (uint32_t n = 0; n < v.len && len < sizeof(buffer) - 1; n++) {
+        if (v.ptr[n] != '_')
+            buffer[len++] = v.ptr[n];
+    }
+    if (len == sizeof(buffer) - 1) {
+        num->format = LIT_NONE;
+        return;
+    }
+    buffer[len] = '\0';
 
-            if ((ppos = string_find_c(tmp, ": ", 0)) != STR_ERROR) {
-                string_right_m(tmp, ppos + 2);
-            }
-            if ((ppos = string_find_c(tmp, ";", 0)) != STR_ERROR) {
-                string_left_m(tmp, ppos - 1);
-            }
+    // subnormal results are kept
+    errno = 0;
+    num->real = strtod(buffer, NULL);
+    num->range = errno == ERANGE && (num->real == 0.0 || num->real > DBL_MAX || num->real < -DBL_MAX);
+}
 
-            string_trim_m(tmp);
-
-            parse_command(tmp, &il_tmp);
-            if (il_tmp->code == IL_CAL || il_tmp->code == IL_CAI) {
-                if ((ppos = string_find_c(tmp, "(", 0)) != STR_ERROR && (ppos = string_find_c(tmp, ")", 0)) == STR_ERROR) {
-                    expanded = string_new_c(tmp->data);
-                    DBG_PRINT("[ start expanded (CAL) ]\n    [ %s ]\n", expanded->data);
-                    is_expanded = true;
-                    is_var = false;
-                    free(tmp);
-                    free(linebf);
-                    continue;
-                }
-            }
+/*
+ * Scan a number once: [-]digits[.digits][E[-]digits] (base 10) or [-]digits (base 2, 8 or 16),
+ * '_' allowed between digits. Integers are accumulated with overflow check, reals use the
+ * Clinger fast path (mantissa up to 2^53 and power of ten up to 22: one exact operation)
+ * and strtod otherwise.
+ */
+static il_number_t view_number(il_view_t v, uint8_t base) {
+    il_number_t num = { LIT_NONE, false, false, 0, 0.0 };
+    uint32_t n = 0, count, frac = 0;
+    uint64_t exp = 0;
+    bool exp_negative = false, exp_range = false;
+    int64_t e;
+
+    if (v.len > 0 && v.ptr[0] == '-') {
+        num.negative = true;
+        ++n;
+    }
 
-            if ((il_tmp->code == IL_VAD || il_tmp->code == IL_VAO)&& (ppos = string_find_c(tmp, "END_VAR", 0)) == STR_ERROR) {
-                expanded = string_new_c(tmp->data);
-                DBG_PRINT("[ start expanded (VAR) ]\n    [ %s ]\n", tmp->data);
-                is_expanded = true;
-                is_var = true;
-                free(tmp);
-                free(linebf);
-                continue;
-            }
+    n = scan_digits(v, n, base, &num.integer, &count, &num.range);
+    if (base == 10 && n < v.len && v.ptr[n] == '.') {
+        n = scan_digits(v, n + 1, base, &num.integer, &frac, &num.range);
+        num.format = LIT_REAL;
+    }
+    if (count + frac == 0)
+        return (il_number_t){ .format = LIT_NONE };
+    if (base == 10 && n < v.len && (v.ptr[n] == 'E' || v.ptr[n] == 'e')) {
+        if (++n < v.len && (v.ptr[n] == '-' || v.ptr[n] == '+'))
+            exp_negative = v.ptr[n++] == '-';
+        n = scan_digits(v, n, base, &exp, &count, &exp_range);
+        if (count == 0)
+            return (il_number_t){ .format = LIT_NONE };
+        num.format = LIT_REAL_EXP;
+    }
+    if (n != v.len)
+        return (il_number_t){ .format = LIT_NONE };
 
-            if (il_tmp->code == IL_VAD || il_tmp->code == IL_VAO) {
-                uint32_t pos;
-                while ((pos = string_find_c(linebf, " = ", 0)) != STR_ERROR) {
-                    string_replace_c_m(linebf, " = ", "=", 0);
-                }
-                while ((pos = string_find_c(linebf, "= ", 0)) != STR_ERROR) {
-                    string_replace_c_m(linebf, "= ", "=", 0);
-                }
-                while ((pos = string_find_c(linebf, ", ", 0)) != STR_ERROR) {
-                    string_replace_c_m(linebf, ", ", ",", 0);
-                }
+    if (num.format == LIT_NONE) {
+        num.format = LIT_INTEGER;
+        return num;
+    }
 
-                while ((pos = string_find_c(linebf, "  ", 0)) != STR_ERROR) {
-                    string_replace_c_m(linebf, "  ", " ", 0);
-                }
-            }
+    e = exp_range || exp > INT32_MAX ? INT32_MAX : (int64_t) exp;
+    e = (exp_negative ? -e : e) - frac;
+    if (!num.range && num.integer <= (1ULL << 53) && e >= -22 && e <= 22) {
+        num.real = e < 0 ? (double) num.integer / pow10_exact[-e] : (double) num.integer * pow10_exact[e];
+        if (num.negative)
+            num.real = -num.real;
+    } else
+        number_strtod(v, &num);
 
-            free(tmp);
-        } else {
-            String tmp = string_new_c(linebf->data);
+    return num;
+}
 
-            // modify VAR
-            if (il_tmp->code == IL_VAD || il_tmp->code == IL_VAO) {
-                string_replace_c_m(tmp, ":", " =", 0);
-                string_replace_c_m(tmp, ";", " ", 0);
+// integer of number in range of iec type (based: bit pattern up to 64 bits)
+static bool number_integer(const il_number_t *num, il_datatype_t type, bool based, int64_t *value) {
+    int64_t min = INT64_MIN;
+    uint64_t max = based ? UINT64_MAX : INT64_MAX;
 
-                uint32_t pos;
-                while ((pos = string_find_c(expanded, " = ", 0)) != STR_ERROR) {
-                    string_replace_c_m(expanded, " = ", "=", 0);
-                }
-                while ((pos = string_find_c(expanded, "= ", 0)) != STR_ERROR) {
-                    string_replace_c_m(expanded, "= ", "=", 0);
-                }
-                while ((pos = string_find_c(expanded, ", ", 0)) != STR_ERROR) {
-                    string_replace_c_m(expanded, ", ", ",", 0);
-                }
+    if (num->format != LIT_INTEGER || num->range)
+        return false;
 
-                while ((pos = string_find_c(expanded, "  ", 0)) != STR_ERROR) {
-                    string_replace_c_m(expanded, "  ", " ", 0);
-                }
-            }
-            ////////////////
+    if (type >= IEC_T_BOOL && type <= IEC_T_LWORD) {
+        min = integer_range[type].min;
+        max = integer_range[type].max;
+    }
 
-            if ((ppos = string_find_c(tmp, ";", 0)) != STR_ERROR) {
-                string_left_m(tmp, ppos - 1);
-            }
+    if (num->negative) {
+        if (num->integer > (uint64_t) -(min + 1) + 1)
+            return false;
+        *value = (int64_t) (0 - num->integer);
+    } else {
+        if (num->integer > max)
+            return false;
+        *value = (int64_t) num->integer;
+    }
 
-            string_concat_m(expanded, spc);
-            string_concat_m(expanded, tmp);
+    return true;
+}
 
-            DBG_PRINT("    [ %s ]\n", tmp->data);
-            free(tmp);
+// integer of base, LONG_MAX if illegal
+static long view_tolong(il_view_t v, uint8_t base) {
+    il_number_t num = view_number(v, base);
+    int64_t value;
 
-            if (!is_var && (ppos = string_find_c(expanded, ")", 0)) == STR_ERROR) {
-                free(linebf);
-                continue;
-            }
+    if (!number_integer(&num, IEC_T_NULL, false, &value))
+        return LONG_MAX;
 
-            if (is_var && (ppos = string_find_c(expanded, "END_VAR", 0)) == STR_ERROR) {
-                free(linebf);
-                continue;
-            }
-            DBG_PRINT("[ end expanded ]\n\n");
-        }
+    return value;
+}
 
-        /////////////////////////
+// number, DBL_MAX if illegal
+static double view_todouble(il_view_t v) {
+    il_number_t num = view_number(v, 10);
 
-        *program = realloc(*program, (lines + 1) * sizeof(String));
-        if (!is_expanded)
-            (*program)[lines++] = string_new_c(linebf->data);
-        else {
-            (*program)[lines++] = string_new_c(expanded->data);
-            free(expanded);
-            is_expanded = false;
-        }
+    if (num.format == LIT_NONE || num.range)
+        return DBL_MAX;
+    if (num.format == LIT_INTEGER)
+        return num.negative ? -(double) num.integer : (double) num.integer;
+
+    return num.real;
+}
+
+///////////////////////////////////////////////////////////////
+
+/////////////////////////// symbols ///////////////////////////
 
-        free(linebf);
+static uint8_t symbols_key[16] = { 'i', 'l', '_', 'p', 'a', 'r', 's', 'e', 'r', '_', 's', 'y', 'm', 'b', 'o', 'l' };
+
+static uint32_t symbol_hash(const char *name, uint32_t len) {
+    string_hash_t hash = string_hash_c(name, len, HSIP32, symbols_key);
+
+    return hash.out[0] | hash.out[1] << 8 | hash.out[2] << 16 | (uint32_t) hash.out[3] << 24;
+}
+
+// hash table slot of name (empty slot if not exist)
+static uint32_t* symbols_slot(const il_symbols_t *symbols, const char *name, uint32_t len, uint32_t hash) {
+    uint32_t n = hash & (symbols->cap - 1);
+    String sym;
+
+    while (symbols->index[n] != 0) {
+        sym = symbols->name[symbols->index[n] - 1];
+        if (symbols->hash[symbols->index[n] - 1] == hash && sym->length == len && !memcmp(sym->data, name, len))
+            break;
+        n = (n + 1) & (symbols->cap - 1);
     }
 
-    free(spc);
-    free(line_buf);
-    free(il_tmp);
-    fclose(f);
+    return &(symbols->index[n]);
+}
 
-    return lines;
+/**
+ * @fn void il_symbols_init(il_symbols_t *symbols, il_arena_t *arena)
+ * @brief Initialize symbols table
+ *
+ * @param symbols Symbols
+ * @param arena Names memory (NULL: heap, released by il_symbols_free)
+ */
+void il_symbols_init(il_symbols_t *symbols, il_arena_t *arena) {
+    symbols->qty = 0;
+    symbols->cap = 64;
+    symbols->index = il_calloc(symbols->cap, sizeof(uint32_t));
+    symbols->name = il_malloc((symbols->cap / 2) * sizeof(String));
+    symbols->hash = il_malloc((symbols->cap / 2) * sizeof(uint32_t));
+    symbols->arena = arena;
+}
+
+/**
+ * @fn uint32_t il_symbols_intern(il_symbols_t *symbols, const char *name, uint32_t len)
+ * @brief Symbol id of name, added if not exists. Name is symbols->name[id]
+ *
+ * @param symbols Symbols
+ * @param name Name (does not need to be null terminated)
+ * @param len Name length
+ * @return Symbol id
+ */
+uint32_t il_symbols_intern(il_symbols_t *symbols, const char *name, uint32_t len) {
+    uint32_t hash = symbol_hash(name, len);
+    uint32_t *slot = symbols_slot(symbols, name, len, hash);
+
+    if (*slot != 0)
+        return *slot - 1;
+
+    symbols->name[symbols->qty] = view_string(symbols->arena, (il_view_t){ (char*) name, len });
+    symbols->hash[symbols->qty] = hash;
+    *slot = ++symbols->qty;
+
+    // keep load factor under 1/2
+    if (symbols->qty == symbols->cap / 2) {
+        il_free(symbols->index);
+        symbols->cap *= 2;
+        symbols->index = il_calloc(symbols->cap, sizeof(uint32_t));
+        symbols->name = il_realloc(symbols->name, (symbols->cap / 2) * sizeof(String));
+        symbols->hash = il_realloc(symbols->hash, (symbols->cap / 2) * sizeof(uint32_t));
+
+        for (uint32_t n = 0; n < symbols->qty; n++)
+            *symbols_slot(symbols, symbols->name[n]->data, symbols->name[n]->length, symbols->hash[n]) = n + 1;
+    }
+
+    return symbols->qty - 1;
+}
+
+/**
+ * @fn uint32_t il_symbols_find(const il_symbols_t *symbols, const char *name, uint32_t len)
+ * @brief Symbol id of name
+ *
+ * @param symbols Symbols
+ * @param name Name (does not need to be null terminated)
+ * @param len Name length
+ * @return Symbol id (IL_NO_SYMBOL if not exists)
+ */
+uint32_t il_symbols_find(const il_symbols_t *symbols, const char *name, uint32_t len) {
+    uint32_t *slot = symbols_slot(symbols, name, len, symbol_hash(name, len));
+
+    return *slot == 0 ? IL_NO_SYMBOL : *slot - 1;
+}
+
+/**
+ * @fn void il_symbols_free(il_symbols_t *symbols)
+ * @brief Free symbols table (and names if they are not in an arena)
+ *
+ * @param symbols Symbols
+ */
+void il_symbols_free(il_symbols_t *symbols) {
+    if (symbols->arena == NULL) {
+        for (uint32_t n = 0; n < symbols->qty; n++)
+            string_free(symbols->name[n]);
+    }
+    il_free(symbols->name);
+    il_free(symbols->hash);
+    il_free(symbols->index);
+
+    symbols->name = NULL;
+    symbols->hash = NULL;
+    symbols->index = NULL;
+    symbols->qty = symbols->cap = 0;
+}
+
+// identifier and its symbol id: interned name if there is a symbols table
+static String view_symbol_id(il_arena_t *arena, il_symbols_t *symbols, il_view_t v, uint32_t *id) {
+    if (symbols == NULL) {
+        *id = IL_NO_SYMBOL;
+        return view_string(arena, v);
+    }
+
+    *id = il_symbols_intern(symbols, v.ptr, v.len);
+
+    return symbols->name[*id];
+}
+
+// identifier: interned name if there is a symbols table
+static String view_symbol(il_arena_t *arena, il_symbols_t *symbols, il_view_t v) {
+    uint32_t id;
+
+    return view_symbol_id(arena, symbols, v, &id);
 }
 
 ///////////////////////////////////////////////////////////////
 
 /////////////////////// parse data types //////////////////////
 
-static uint32_t identify_lit_dataformat(String value) {
-    for (uint32_t n = 0; n < 13; n++) {
-        if (string_find_c(value, pfx_dataformat[n], 0) != STR_ERROR) {
-            return literal_format[n];
-        }
-    }
+typedef struct il_literal_s {
+    il_dataformat_t format;  // literal data format
+      il_datatype_t type;    // iec data type
+           uint32_t payload; // offset of value after prefixes
+} il_literal_t;
+
+enum LITERAL_CLASS {
+    LC_OTHER, // any other character
+    LC_DIGIT, // 0-9
+    LC_ALPHA, // letters except E
+    LC_E,     // E (exponent or letter)
+    LC_UNDER, // _
+    LC_DOT,   // .
+    LC_MINUS, // -
+};
+
+enum LITERAL_STATE {
+    LS_START,    // start of value
+    LS_SIGN,     // -
+    LS_INT,      // digits
+    LS_DOT,      // . without integer part
+    LS_FRAC,     // digits.digits
+    LS_EXP,      // number E
+    LS_EXP_SIGN, // number E-
+    LS_EXP_INT,  // number E digits
+    LS_INT_SEP,  // digits_
+    LS_FRAC_SEP, // digits.digits_
+    LS_EXP_SEP,  // number E digits_
+    LS_IDENT,    // identifier
+    LS_ERROR     // not a literal
+};
 
-    if ((value->data[0] == '"' && value->data[value->length - 1] == '"') || (value->data[0] == '\'' && value->data[value->length - 1] == '\''))
-        return LIT_STRING;
+static const uint8_t literal_class[256] = {
+    ['0' ... '9'] = LC_DIGIT,
+    ['A' ... 'D'] = LC_ALPHA,
+    ['E'] = LC_E,
+    ['F' ... 'Z'] = LC_ALPHA,
+    ['a' ... 'd'] = LC_ALPHA,
+    ['e'] = LC_E,
+    ['f' ... 'z'] = LC_ALPHA,
+    ['_'] = LC_UNDER,
+    ['.'] = LC_DOT,
+    ['-'] = LC_MINUS,
+};
 
-    if(string_isinteger(value))
-        return LIT_INTEGER;
+static const uint8_t literal_next[LS_ERROR][LC_MINUS + 1] = {
+    //               OTHER     DIGIT       ALPHA     E          UNDER        DOT       MINUS
+    [LS_START]    = { LS_ERROR, LS_INT,     LS_IDENT, LS_IDENT,  LS_IDENT,    LS_DOT,   LS_SIGN     },
+    [LS_SIGN]     = { LS_ERROR, LS_INT,     LS_ERROR, LS_ERROR,  LS_ERROR,    LS_DOT,   LS_ERROR    },
+    [LS_INT]      = { LS_ERROR, LS_INT,     LS_ERROR, LS_EXP,    LS_INT_SEP,  LS_FRAC,  LS_ERROR    },
+    [LS_DOT]      = { LS_ERROR, LS_FRAC,    LS_ERROR, LS_ERROR,  LS_ERROR,    LS_ERROR, LS_ERROR    },
+    [LS_FRAC]     = { LS_ERROR, LS_FRAC,    LS_ERROR, LS_EXP,    LS_FRAC_SEP, LS_ERROR, LS_ERROR    },
+    [LS_EXP]      = { LS_ERROR, LS_EXP_INT, LS_ERROR, LS_ERROR,  LS_ERROR,    LS_ERROR, LS_EXP_SIGN },
+    [LS_EXP_SIGN] = { LS_ERROR, LS_EXP_INT, LS_ERROR, LS_ERROR,  LS_ERROR,    LS_ERROR, LS_ERROR    },
+    [LS_EXP_INT]  = { LS_ERROR, LS_EXP_INT, LS_ERROR, LS_ERROR,  LS_EXP_SEP,  LS_ERROR, LS_ERROR    },
+    [LS_INT_SEP]  = { LS_ERROR, LS_INT,     LS_ERROR, LS_ERROR,  LS_ERROR,    LS_ERROR, LS_ERROR    },
+    [LS_FRAC_SEP] = { LS_ERROR, LS_FRAC,    LS_ERROR, LS_ERROR,  LS_ERROR,    LS_ERROR, LS_ERROR    },
+    [LS_EXP_SEP]  = { LS_ERROR, LS_EXP_INT, LS_ERROR, LS_ERROR,  LS_ERROR,    LS_ERROR, LS_ERROR    },
+    [LS_IDENT]    = { LS_ERROR, LS_IDENT,   LS_IDENT, LS_IDENT,  LS_IDENT,    LS_IDENT, LS_ERROR    },
+};
 
-    if(string_isfloat(value))
-        return LIT_REAL;
+static const uint8_t literal_accept[LS_ERROR + 1] = {
+    [LS_START]    = LIT_NONE,
+    [LS_SIGN]     = LIT_NONE,
+    [LS_INT]      = LIT_INTEGER,
+    [LS_DOT]      = LIT_NONE,
+    [LS_FRAC]     = LIT_REAL,
+    [LS_EXP]      = LIT_NONE,
+    [LS_EXP_SIGN] = LIT_NONE,
+    [LS_EXP_INT]  = LIT_REAL_EXP,
+    [LS_INT_SEP]  = LIT_NONE,
+    [LS_FRAC_SEP] = LIT_NONE,
+    [LS_EXP_SEP]  = LIT_NONE,
+    [LS_IDENT]    = LIT_VAR,
+    [LS_ERROR]    = LIT_NONE,
+};
 
-    if (string_isrealexp(value))
-        return LIT_REAL_EXP;
+// numbers are scanned with case and '_' separators as written
+static inline bool literal_numeric(il_dataformat_t format) {
+    return format == LIT_INTEGER || format == LIT_REAL || format == LIT_REAL_EXP || format == LIT_BASE2 || format == LIT_BASE8 || format == LIT_BASE16;
+}
 
-    if ((value->data[0] == 95 || isalpha(value->data[0])) && string_isalnum(value, 0, true))
-        return LIT_VAR;
+// compare prefix (with '#') to word before '#' of value
+static bool prefix_equals(il_view_t word, const char *prefix) {
+    const char *end = strchr(prefix, '#');
 
-    return LIT_NONE;
+    return end - prefix == word.len && !string_memcasecmp(word.ptr, prefix, word.len);
 }
 
-static uint32_t identify_iec_datatype(String value) {
-    for (uint32_t n = 0; n < 32; n++) {
-        if (string_find_c(value, pfx_iectype[n], 0) != STR_ERROR) {
-            return n;
+/*
+ * Classify a literal in one pass: [iec type#][format#]value
+ * Prefixes are anchored at the start of the value, the format prefix ends
+ * classification (payload is parsed by the format parser).
+ */
+static il_literal_t identify_literal(il_view_t value) {
+    il_literal_t lit = { LIT_NONE, IEC_T_NULL, 0 };
+    uint8_t state = LS_START;
+    uint32_t pos, n;
+    il_view_t word;
+
+    for (pos = 0; pos < value.len && state != LS_ERROR; pos++) {
+        char c = value.ptr[pos];
+
+        if (state == LS_START && (c == '"' || c == '\'')) {
+            if (pos + 1 < value.len && value.ptr[value.len - 1] == c)
+                lit.format = LIT_STRING;
+            return lit;
+        }
+
+        if (c == '#' && (state == LS_INT || state == LS_IDENT)) {
+            word = view_left(view_right(value, lit.payload), pos - lit.payload);
+
+            for (n = 0; n < 13; n++) {
+                if (prefix_equals(word, pfx_dataformat[n])) {
+                    lit.format = literal_format[n];
+                    if (lit.type == IEC_T_NULL)
+                        lit.type = literal_type[n];
+                    lit.payload = pos + 1;
+                    return lit;
+                }
+            }
+
+            if (lit.type == IEC_T_NULL) {
+                for (n = 1; n < 32; n++) {
+                    if (prefix_equals(word, pfx_iectype[n])) {
+                        lit.type = n;
+                        break;
+                    }
+                }
+            }
+
+            if (lit.type == IEC_T_NULL || lit.payload != 0)
+                return lit;
+
+            lit.payload = pos + 1;
+            state = LS_START;
+            continue;
         }
+
+        state = literal_next[state][literal_class[(uint8_t) c]];
     }
 
-    return IEC_T_NULL;
+    lit.format = literal_accept[state];
+
+    return lit;
 }
 
 /////////////////////// parse values //////////////////////////
-static void parse_literal(String value, il_dataformat_t lit_dataformat, il_t **result);
+static bool parse_literal(il_view_t value, il_dataformat_t lit_dataformat, il_t **result, il_arena_t *arena, il_symbols_t *symbols, il_error_t *error);
+
+static inline bool parse_error(il_error_t *error, const char *message, il_view_t value) {
+    error->message = message;
+    error->value = value;
+
+    return false;
+}
 
-static void parse_phy(String value, il_t **result) {
-    String l,r;
-    uint8_t a = 0, b = 0;
-    uint16_t w;
+static bool parse_phy(il_view_t value, il_t **result, il_error_t *error) {
+    il_view_t l, r;
+    uint32_t pos;
+    long a = 0, b = 0;
     double d;
 
     (*result)->data.phy.data.bit.phy_a = 0;
@@ -580,114 +940,122 @@ static void parse_phy(String value, il_t **result) {
     (*result)->data.phy.prefix = PHY_P_NONE;
     (*result)->data.phy.datatype = PHY_D_BIT;
 
-    for (uint32_t n = 0; n <= PHY_P_M; n++) {
-        if (value->data[0] == phy_prefix_c[n]) {
-            value->data[0] = ' ';
+    for (uint32_t n = 0; n <= PHY_P_M && value.len > 0; n++) {
+        if (value.ptr[0] == phy_prefix_c[n]) {
             (*result)->data.phy.prefix = n;
+            value = view_right(value, 1);
             break;
         }
     }
     if ((*result)->data.phy.prefix == PHY_P_NONE) {
-        printf("ERROR: data prefix illegal! [%s]\n", value->data);
-        exit(1);
+        return parse_error(error, "data prefix illegal", value);
     }
 
-    for (uint32_t n = 0; n <= PHY_D_DOUBLE; n++) {
-        if (value->data[1] == phy_data_type_c[n]) {
-            value->data[1] = ' ';
+    for (uint32_t n = 0; n <= PHY_D_DOUBLE && value.len > 0; n++) {
+        if (value.ptr[0] == phy_data_type_c[n]) {
             (*result)->data.phy.datatype = n;
+            value = view_right(value, 1);
             break;
         }
     }
 
-    string_trim_m(value);
+    value = view_trim(value);
 
     switch ((*result)->data.phy.datatype) {
         case PHY_D_BIT:
-            if ((l = string_split(value, ".", &r)) == NULL) {
-                printf("ERROR: phy bit format illegal! [%s]\n", value->data);
-                exit(1);
+            if ((pos = view_find(value, ".")) == STR_ERROR) {
+                return parse_error(error, "phy bit format illegal", value);
             }
+            l = view_left(value, pos);
+            r = view_right(value, pos + 1);
 
-            if (string_issigned(l) || string_issigned(r)) {
-                printf("ERROR: phy bit illegal (number signed)! [%s]\n", value->data);
-                exit(1);
+            if (view_issigned(l) || view_issigned(r)) {
+                return parse_error(error, "phy bit illegal (number signed)", value);
             }
 
-            if ((a = string_tolong(l, 10)) != string_tolong(l, 10) || (b = string_tolong(r, 10)) != string_tolong(r, 10)) {
-                printf("ERROR: phy bit illegal (number not byte)(a: %d[%s], b: %d[%s])! [%s]\n", a, l->data, b, r->data, value->data);
-                exit(1);
+            if ((a = view_tolong(l, 10)) > UINT8_MAX || (b = view_tolong(r, 10)) > UINT8_MAX) {
+                return parse_error(error, "phy bit illegal (number not byte)", value);
             }
 
             (*result)->data.phy.data.bit.phy_a = a;
             (*result)->data.phy.data.bit.phy_b = b;
 
-            free(l);
-            free(r);
-
             break;
         case PHY_D_BYTE:
-            if (string_issigned(value)) {
-                printf("ERROR: phy byte illegal (number signed)! [%s]\n", value->data);
-                exit(1);
+            if (view_issigned(value)) {
+                return parse_error(error, "phy byte illegal (number signed)", value);
             }
 
-            if ((a = string_tolong(value, 10)) != string_tolong(value, 10)) {
-                printf("ERROR: phy byte illegal (number not byte)! [%s]\n", value->data);
-                exit(1);
+            if ((a = view_tolong(value, 10)) > UINT8_MAX) {
+                return parse_error(error, "phy byte illegal (number not byte)", value);
             }
 
             (*result)->data.phy.data.byte = a;
 
             break;
         case PHY_D_WORD:
-            if (string_issigned(value)) {
-                printf("ERROR: phy word illegal (number signed)! [%s]\n", value->data);
-                exit(1);
+            if (view_issigned(value)) {
+                return parse_error(error, "phy word illegal (number signed)", value);
             }
 
-            if ((w = string_tolong(value, 10)) != string_tolong(value, 10)) {
-                printf("ERROR: phy word illegal (number not word)! [%s]\n", value->data);
-                exit(1);
+            if ((a = view_tolong(value, 10)) > UINT16_MAX) {
+                return parse_error(error, "phy word illegal (number not word)", value);
             }
 
-            (*result)->data.phy.data.byte = w;
+            (*result)->data.phy.data.word = a;
 
             break;
         case PHY_D_DOUBLE:
-            if ((d = string_todouble(value)) != string_todouble(value)) {
-                printf("ERROR: phy float illegal (number not float)! [%s]\n", value->data);
-                exit(1);
+            if ((d = view_todouble(value)) == DBL_MAX) {
+                return parse_error(error, "phy float illegal (number not float)", value);
             }
 
             (*result)->data.phy.data.dbl = d;
 
             break;
     }
+
+    return true;
 }
 
-static void parse_string(String value, il_t **result) {
-    value->data[0] = ' ';
-    value->data[value->length - 1] = ' ';
-    string_trim_m(value);
-    (*result)->data.str = string_new_c(value->data);
+static void parse_string(il_view_t value, il_t **result, il_arena_t *arena) {
+    value = view_trim(view_left(view_right(value, 1), value.len - 2));
+    (*result)->data.str = view_string(arena, value);
 }
 
-static void parse_boolean(String value, il_t **result) {
-    if (string_equals_c(value, "0") || string_equals_c(value, "FALSE"))
+static bool parse_boolean(il_view_t value, il_t **result, il_error_t *error) {
+    if (view_equals(value, "0") || view_equals(value, "FALSE"))
         (*result)->data.boolean = 0;
-    else if (string_equals_c(value, "1") || string_equals_c(value, "TRUE"))
+    else if (view_equals(value, "1") || view_equals(value, "TRUE"))
         (*result)->data.boolean = 1;
     else {
-        printf("ERROR: boolean illegal! [%s]\n", value->data);
-        exit(1);
+        return parse_error(error, "boolean illegal", value);
+    }
+
+    return true;
+}
+
+// position of duration unit (H, M, S or MS)
+static uint32_t duration_unit(il_view_t value, uint32_t unit, uint32_t *len) {
+    const char pf[3] = { 'H', 'M', 'S' };
+    bool ms;
+
+    for (uint32_t n = 0; n < value.len; n++) {
+        ms = value.ptr[n] == 'M' && n + 1 < value.len && value.ptr[n + 1] == 'S';
+        if ((ms && unit == 3) || (!ms && unit < 3 && value.ptr[n] == pf[unit])) {
+            *len = ms ? 2 : 1;
+            return n;
+        }
+        n += ms;
     }
+
+    return STR_ERROR;
 }
 
-static void parse_duration(String value, il_t **result) {
-    uint32_t pos = 0;
+static bool parse_duration(il_view_t value, il_t **result, il_error_t *error) {
+    uint32_t pos = 0, len;
+    long v;
 
-    const char *pf[4] = { "H", "M", "S", "L" };
     uint8_t *vl[4] = {
             &((*result)->data.tod.hour),
             &((*result)->data.tod.min),
@@ -695,545 +1063,466 @@ static void parse_duration(String value, il_t **result) {
             &((*result)->data.tod.msec)
     };
 
-    string_replace_c_m(value, "MS", "L", 0);
-
     for (uint32_t n = 0; n < 4; n++) {
-        if ((pos = string_find_c(value, pf[n], 0)) != STR_ERROR) {
-            String val = string_left(value, pos - 1);
-            if (!string_isinteger(val) || string_issigned(val)) {
-                printf("ERROR: duration illegal! [%s]\n", val->data);
-                exit(1);
+        if ((pos = duration_unit(value, n, &len)) != STR_ERROR) {
+            il_view_t val = view_left(value, pos);
+            if (view_issigned(val) || (v = view_tolong(val, 10)) == LONG_MAX) {
+                return parse_error(error, "duration illegal", val);
             }
 
-            if ((*vl[n] = string_tolong(val, 10)) != string_tolong(val, 10)) {
-                printf("ERROR: duration illegal (number too long)! [%s]\n", val->data);
-                exit(1);
+            if (v > UINT8_MAX) {
+                return parse_error(error, "duration illegal (number too long)", val);
             }
+            *vl[n] = v;
 
-            string_right_m(value, pos + 1);
-
-            free(val);
+            value = view_right(value, pos + len);
         } else
             *vl[n] = 0;
     }
+
+    return true;
 }
 
-static void parse_time_of_day(String value, il_t **result) {
+static bool parse_time_of_day(il_view_t value, il_t **result, il_error_t *error) {
+    il_number_t num;
     uint32_t pos;
-    String v, tmp;
-
-    if ((pos = string_find_c(value, ":", 0)) == STR_ERROR) {
-        printf("ERROR: time of day illegal! [%s]\n", value->data);
-        exit(1);
-    }
-    v = string_left(value, pos - 1);
-    if (!string_isinteger(v)
-            || string_issigned(v)
-            || (((*result)->data.tod.hour = string_tolong(v, 10)) != string_tolong(v, 10))
-            || (*result)->data.tod.hour > 23)
-    {
-        printf("ERROR: time of day illegal! [%s]\n", value->data);
-        exit(1);
-    }
-    free(v);
-    string_right_m(value, pos + 1);
-
-    if ((pos = string_find_c(value, ":", 0)) == STR_ERROR) {
-        printf("ERROR: time of day illegal! [%s]\n", value->data);
-        exit(1);
-    }
-    v = string_left(value, pos - 1);
-    if (!string_isinteger(v)
-            || string_issigned(v)
-            || (((*result)->data.tod.min = string_tolong(v, 10)) != string_tolong(v, 10))
-            || (*result)->data.tod.min > 59)
-    {
-        printf("ERROR: time of day illegal! [%s]\n", value->data);
-        exit(1);
-    }
-    free(v);
-    string_right_m(value, pos + 1);
-
-    if (!string_isfloat(value)
-                || string_issigned(value)
-                || string_todouble(value) > 59.999)
-        {
-        printf("ERROR: time of day illegal! [%s]\n", value->data);
-        exit(1);
+    il_view_t v;
+    long n;
+
+    if ((pos = view_find(value, ":")) == STR_ERROR) {
+        return parse_error(error, "time of day illegal", value);
+    }
+    v = view_left(value, pos);
+    if (view_issigned(v) || (n = view_tolong(v, 10)) > 23) {
+        return parse_error(error, "time of day illegal", value);
+    }
+    (*result)->data.tod.hour = n;
+    value = view_right(value, pos + 1);
+
+    if ((pos = view_find(value, ":")) == STR_ERROR) {
+        return parse_error(error, "time of day illegal", value);
+    }
+    v = view_left(value, pos);
+    if (view_issigned(v) || (n = view_tolong(v, 10)) > 59) {
+        return parse_error(error, "time of day illegal", value);
+    }
+    (*result)->data.tod.min = n;
+    value = view_right(value, pos + 1);
+
+    num = view_number(value, 10);
+    if (num.negative || (num.format != LIT_INTEGER && num.format != LIT_REAL) || view_todouble(value) > 59.999) {
+        return parse_error(error, "time of day illegal", value);
+    }
+
+    if ((pos = view_find(value, ".")) == STR_ERROR) {
+        (*result)->data.tod.sec = view_tolong(value, 10);
+        (*result)->data.tod.msec = 0;
     } else {
-        if (string_isinteger(value)) {
-            (*result)->data.tod.sec = string_tolong(value, 10);
-            (*result)->data.tod.msec = 0;
-        } else {
-            tmp = string_left(value, string_find_c(value, ".", 0) - 1);
-            (*result)->data.tod.sec = string_tolong(tmp, 10);
-            free(tmp);
-            tmp = string_right(value, string_find_c(value, ".", 0) + 1);
-            (*result)->data.tod.msec = string_tolong(tmp, 10);
-            free(tmp);
-        }
+        (*result)->data.tod.sec = view_tolong(view_left(value, pos), 10);
+        (*result)->data.tod.msec = view_tolong(view_right(value, pos + 1), 10);
     }
+
+    return true;
 }
 
-static void parse_date(String value, il_t **result) {
+static bool parse_date(il_view_t value, il_t **result, il_error_t *error) {
     uint32_t pos;
-    String v;
+    il_view_t v;
+    long n;
 
-    if ((pos = string_find_c(value, "-", 0)) == STR_ERROR) {
-        printf("ERROR: time of day illegal! [%s]\n", value->data);
-        exit(1);
+    if ((pos = view_find(value, "-")) == STR_ERROR) {
+        return parse_error(error, "date illegal", value);
     }
-    v = string_left(value, pos - 1);
-    if (!string_isinteger(v)
-            || string_issigned(v)
-            || (((*result)->data.date.year = string_tolong(v, 10)) != string_tolong(v, 10))
-            || (*result)->data.date.year < 1)
-    {
-        printf("ERROR: date illegal! [%s]\n", value->data);
-        exit(1);
+    v = view_left(value, pos);
+    if (view_issigned(v) || (n = view_tolong(v, 10)) > UINT16_MAX || n < 1) {
+        return parse_error(error, "date illegal", value);
     }
-    free(v);
-    string_right_m(value, pos + 1);
+    (*result)->data.date.year = n;
+    value = view_right(value, pos + 1);
 
-    if ((pos = string_find_c(value, "-", 0)) == STR_ERROR) {
-        printf("ERROR: time of day illegal! [%s]\n", value->data);
-        exit(1);
+    if ((pos = view_find(value, "-")) == STR_ERROR) {
+        return parse_error(error, "date illegal", value);
     }
-    v = string_left(value, pos - 1);
-    if (!string_isinteger(v)
-            || string_issigned(v)
-            || (((*result)->data.date.month = string_tolong(v, 10)) != string_tolong(v, 10))
-            || (*result)->data.date.month > 12 || (*result)->data.date.month < 1)
-    {
-        printf("ERROR: date illegal! [%s]\n", value->data);
-        exit(1);
+    v = view_left(value, pos);
+    if (view_issigned(v) || (n = view_tolong(v, 10)) > 12 || n < 1) {
+        return parse_error(error, "date illegal", value);
     }
-    free(v);
-    string_right_m(value, pos + 1);
+    (*result)->data.date.month = n;
+    value = view_right(value, pos + 1);
 
-    if (!string_isinteger(value)
-            || string_issigned(value)
-            || (((*result)->data.date.day = string_tolong(value, 10)) != string_tolong(value, 10))
-            || (*result)->data.date.day > 31
-            || (*result)->data.date.day < 1)
-    {
-        printf("ERROR: date illegal! [%s]\n", value->data);
-        exit(1);
+    if (view_issigned(value) || (n = view_tolong(value, 10)) > 31 || n < 1) {
+        return parse_error(error, "date illegal", value);
     }
+    (*result)->data.date.day = n;
 
-
+    return true;
 }
 
-static void parse_date_and_time(String value, il_t **result) {
-    if (value->data[10] != '-') {
-        printf("ERROR: date and time illegal! [%s]\n", value->data);
-        exit(1);
+static bool parse_date_and_time(il_view_t value, il_t **result, il_error_t *error) {
+    if (value.len <= 10 || value.ptr[10] != '-') {
+        return parse_error(error, "date and time illegal", value);
     }
 
-    il_t *val = malloc(sizeof(il_t));
-    String vl;
+    il_t val;
+    il_t *pval = &val;
 
-    vl = string_left(value, 9);
-    parse_date(vl, &val);
-    (*result)->data.dt.date.year = val->data.date.year;
-    (*result)->data.dt.date.month = val->data.date.month;
-    (*result)->data.dt.date.day = val->data.date.day;
-    free(vl);
+    if (!parse_date(view_left(value, 10), &pval, error))
+        return false;
+    (*result)->data.dt.date.year = val.data.date.year;
+    (*result)->data.dt.date.month = val.data.date.month;
+    (*result)->data.dt.date.day = val.data.date.day;
 
-    vl = string_right(value, 11);
-    parse_time_of_day(vl, &val);
-    (*result)->data.dt.tod.hour = val->data.tod.hour;
-    (*result)->data.dt.tod.min = val->data.tod.min;
-    (*result)->data.dt.tod.sec = val->data.tod.sec;
-    (*result)->data.dt.tod.msec = val->data.tod.msec;
-    free(vl);
+    if (!parse_time_of_day(view_right(value, 11), &pval, error))
+        return false;
+    (*result)->data.dt.tod.hour = val.data.tod.hour;
+    (*result)->data.dt.tod.min = val.data.tod.min;
+    (*result)->data.dt.tod.sec = val.data.tod.sec;
+    (*result)->data.dt.tod.msec = val.data.tod.msec;
 
-    free(val);
+    return true;
 }
 
-static void parse_integer(String value, il_t **result) {
-    if (!string_isinteger(value)) {
-        printf("ERROR: integer illegal! [%s]\n", value->data);
-        exit(1);
-    }
+static bool parse_integer(il_view_t value, il_t **result, il_error_t *error) {
+    il_number_t num = view_number(value, 10);
 
-    if (((*result)->data.integer = string_tolong(value, 10)) != string_tolong(value, 10)) {
-        printf("ERROR: integer illegal! [%s]\n", value->data);
-        exit(1);
+    if (num.format != LIT_INTEGER) {
+        return parse_error(error, "integer illegal", value);
     }
-}
 
-static void parse_real(String value, il_t **result) {
-    if (!string_isfloat(value)) {
-        printf("ERROR: real illegal! [%s]\n", value->data);
-        exit(1);
+    if (!number_integer(&num, (*result)->iec_datatype, false, &((*result)->data.integer))) {
+        return parse_error(error, "integer illegal (out of range)", value);
     }
 
-    if (((*result)->data.real = string_todouble(value)) != string_todouble(value)) {
-        printf("ERROR: real illegal! [%s]\n", value->data);
-        exit(1);
-    }
+    return true;
 }
 
-static void parse_real_exp(String value, il_t **result) {
-    uint8_t type = string_isrealexp(value);
-    if (type == 0) {
-        printf("ERROR: real exp illegal! [%s]\n", value->data);
-        exit(1);
+static bool parse_real(il_view_t value, il_dataformat_t format, il_t **result, il_error_t *error) {
+    il_number_t num = view_number(value, 10);
+
+    if (num.format != format) {
+        return parse_error(error, format == LIT_REAL ? "real illegal" : "real exp illegal", value);
     }
 
-    if (((*result)->data.real = string_todouble(value)) != string_todouble(value)) {
-        printf("ERROR: real exp illegal! [%s]\n", value->data);
-        exit(1);
+    if (num.range || ((*result)->iec_datatype == IEC_T_REAL && (num.real > FLT_MAX || num.real < -FLT_MAX))) {
+        return parse_error(error, "real illegal (out of range)", value);
     }
+
+    (*result)->data.real = num.real;
+
+    return true;
 }
 
-static void parse_base(String value, il_t **result) {
-    string_right_m(value, string_find_c(value, "#", 0) + 1);
+static bool parse_base(il_view_t value, il_t **result, il_error_t *error) {
+    il_number_t num;
+
     switch ((*result)->lit_dataformat) {
         case LIT_BASE2:
-            if (((*result)->data.integer = string_tolong(value, 2)) != string_tolong(value, 2)) {
-                printf("ERROR: integer illegal! [%s]\n", value->data);
-                exit(1);
-            }
+            num = view_number(value, 2);
             break;
         case LIT_BASE8:
-            if (((*result)->data.integer = string_tolong(value, 8)) != string_tolong(value, 8)) {
-                printf("ERROR: integer illegal! [%s]\n", value->data);
-                exit(1);
-            }
+            num = view_number(value, 8);
             break;
         case LIT_BASE16:
-            string_tolower_m(value);
-            if (((*result)->data.integer = string_tolong(value, 16)) != string_tolong(value, 16)) {
-                printf("ERROR: integer illegal! [%s]\n", value->data);
-                exit(1);
-            }
+            num = view_number(value, 16);
             break;
         default:
-            printf("ERROR: base illegal! [%s]\n", value->data);
-            exit(1);
+            return parse_error(error, "base illegal", value);
     }
-}
-
-static void parse_cal(String value, il_t **result) {
-    uint32_t pos;
 
-    pos = string_find_c(value, " ", 0);
-    (*result)->data.cal.func = string_left(value, pos - 1);
-    DBG_PRINT("    [func: %s]\n", (*result)->data.cal.func->data);
+    if (num.format != LIT_INTEGER) {
+        return parse_error(error, "base illegal", value);
+    }
 
-    string_right_m(value, pos + 1);
-    if (value->data[0] == '(')
-        value->data[0] = ' ';
-    string_delete_postfix_c_m(value, ")");
-    string_trim_m(value);
+    if (!number_integer(&num, (*result)->iec_datatype, true, &((*result)->data.integer))) {
+        return parse_error(error, "base illegal (out of range)", value);
+    }
 
-    (*result)->data.cal.len = 0;
-    (*result)->data.cal.not_formal = false;
-    (*result)->data.cal.value = malloc(sizeof(il_t));
-    (*result)->data.cal.var = malloc(sizeof(String));
-    (*result)->data.cal.in_out = malloc(sizeof(bool));
-
-    void internal(String pos_var, il_t **result) {
-        uint32_t peq_in, peq_out;
-        String var_val;
-        if ((peq_in = string_find_c(pos_var, ":=", 0)) == STR_ERROR && (peq_out = string_find_c(pos_var, "=>", 0)) == STR_ERROR)
-            (*result)->data.cal.not_formal = true;
-
-        if(peq_out != STR_ERROR)
-            peq_in = peq_out;
-
-        if (peq_in != STR_ERROR && (*result)->data.cal.not_formal) {
-            printf("ERROR: cal illegal (formal/not formal)! [%s]\n", value->data);
-            exit(1);
-        }
+    return true;
+}
 
-        (*result)->data.cal.value = realloc((*result)->data.cal.value, ((*result)->data.cal.len + 1) * sizeof(il_t));
-        (*result)->data.cal.var = realloc((*result)->data.cal.var, ((*result)->data.cal.len + 1) * sizeof(String));
-        (*result)->data.cal.in_out = realloc((*result)->data.cal.in_out, ((*result)->data.cal.len + 1) * sizeof(bool));
-        il_t *cv = &((*result)->data.cal.value[(*result)->data.cal.len]);
+static bool parse_cal_arg(il_view_t arg, il_t **result, il_arena_t *arena, il_symbols_t *symbols, const il_listener_t *listener, il_error_t *error) {
+    uint32_t peq_in, peq_out = STR_ERROR;
+    il_cal_arg_t *ca = &((*result)->data.cal.arg[(*result)->data.cal.len]);
+    uint32_t len = (*result)->data.cal.len;
+    il_literal_t lit;
+    il_view_t var_val;
+    il_t *cv = &(ca->value);
 
-        (*result)->data.cal.in_out[(*result)->data.cal.len] = (peq_out != STR_ERROR) ? 1 : 0;
+    if ((peq_in = view_find(arg, ":=")) == STR_ERROR && (peq_out = view_find(arg, "=>")) == STR_ERROR)
+        (*result)->data.cal.not_formal = true;
 
-        if (!(*result)->data.cal.not_formal) {
-            (*result)->data.cal.var[(*result)->data.cal.len] = string_left(pos_var, peq_in - 1);
-            var_val = string_right(pos_var, peq_in + 2);
-        } else {
-            (*result)->data.cal.var[(*result)->data.cal.len] = string_new_c("NOT_FORMAL");
-            var_val = string_new_c(pos_var->data);
-        }
+    if (peq_out != STR_ERROR)
+        peq_in = peq_out;
 
-        (*result)->data.cal.value[(*result)->data.cal.len].lit_dataformat = identify_lit_dataformat(var_val);
-        (*result)->data.cal.value[(*result)->data.cal.len].iec_datatype = identify_iec_datatype(var_val);
+    if (peq_in != STR_ERROR && (*result)->data.cal.not_formal) {
+        return parse_error(error, "cal illegal (formal/not formal)", arg);
+    }
 
-        DBG_PRINT("    [ %s [in/out: %d] lit_dataformat: %s, iec_datatype: %s ]\n",
-                     (*result)->data.cal.var[(*result)->data.cal.len]->data,
-                     (*result)->data.cal.in_out[(*result)->data.cal.len],
-                     lit_dataformat_str[(*result)->data.cal.value[(*result)->data.cal.len].lit_dataformat],
-                     pfx_iectype[(*result)->data.cal.value[(*result)->data.cal.len].iec_datatype]
-                 );
+    ca->in_out = (peq_out != STR_ERROR) ? 1 : 0;
 
-        uint32_t spc = string_find_c(var_val, "#", 0);
-        string_right_m(var_val, spc + 1);
+    if (!(*result)->data.cal.not_formal) {
+        ca->var = view_symbol(arena, symbols, view_trim(view_left(arg, peq_in)));
+        var_val = view_trim(view_right(arg, peq_in + 2));
+    } else {
+        ca->var = view_symbol(arena, symbols, (il_view_t){ "NOT_FORMAL", 10 });
+        var_val = arg;
+    }
 
-        if ((*result)->data.cal.value[(*result)->data.cal.len].lit_dataformat != LIT_STRING
-                && (*result)->data.cal.value[(*result)->data.cal.len].lit_dataformat != LIT_VAR) {
-            string_toupper_m(var_val);
-            while (string_find_c(var_val, "_", 0) != STR_ERROR) {
-                string_delete_c_m(var_val, "_");
-            }
-        }
+    lit = identify_literal(var_val);
+    cv->lit_dataformat = lit.format;
+    cv->iec_datatype = lit.type;
 
-        parse_literal(var_val, (*result)->data.cal.value[(*result)->data.cal.len].lit_dataformat, &cv);
 
-        ++((*result)->data.cal.len);
+    var_val = view_right(var_val, lit.payload);
 
-        string_right_m(value, pos + 1);
-        string_trim_m(value);
-        free(var_val);
+    if (cv->lit_dataformat != LIT_STRING && cv->lit_dataformat != LIT_VAR && !literal_numeric(cv->lit_dataformat)) {
+        view_toupper(var_val);
+        var_val = view_delete_c(var_val, '_');
     }
 
-    while ((pos = string_find_c(value, ",", 0)) != STR_ERROR) {
-        String pos_var = string_left(value, pos -1);
-        internal(pos_var, result);
-        free(pos_var);
-    }
+    // counted before parsing value so free_il releases var name on error
+    ++((*result)->data.cal.len);
 
-    String pos_var = string_right(value, pos + 1);
-    internal(pos_var, result);
+    if (!parse_literal(var_val, cv->lit_dataformat, &cv, arena, symbols, error))
+        return false;
+    IL_EMIT(listener, literal, *result, len);
 
-    free(pos_var);
+    return true;
 }
 
-static void parse_vad(String value, il_t **result) {
-    uint32_t pos, vars_qty;
-    String *vars;
+static bool parse_cal(il_view_t func, il_view_t args, il_t **result, il_arena_t *arena, il_symbols_t *symbols, const il_listener_t *listener, il_error_t *error) {
+    uint32_t pos;
 
-    string_replace_c_m(value, "END_VAR", "", 0);
-    string_trim_m(value);
+    (*result)->data.cal.func = view_symbol(arena, symbols, func);
 
-    (*result)->data.vad.len = 0;
-    (*result)->data.vad.var = malloc(sizeof(String));
-    (*result)->data.vad.value = malloc(sizeof(String));
+    args = view_trim(args);
+    if (args.len > 0 && args.ptr[0] == '(')
+        args = view_right(args, 1);
+    if (args.len > 0 && args.ptr[args.len - 1] == ')')
+        --args.len;
+    args = view_trim(args);
+
+    (*result)->data.cal.len = 0;
+    (*result)->data.cal.not_formal = false;
+    (*result)->data.cal.arg = NULL;
+
+    // one block for all arguments (upper bound: separators + 1)
+    if (args.len > 0)
+        (*result)->data.cal.arg = il_arena_alloc(arena, (view_count_unquoted(args, ',') + 1) * sizeof(il_cal_arg_t));
+
+    while (args.len > 0) {
+        pos = view_find_unquoted(args, ',');
+        if (!parse_cal_arg(view_trim(view_left(args, pos)), result, arena, symbols, listener, error))
+            return false;
+        if (pos == STR_ERROR)
+            break;
+        args = view_right(args, pos + 1);
+    }
+
+    return true;
+}
 
-    if ((vars_qty = string_split_array(value, " ", &vars)) == 0) {
-        vars_qty = 1;
-        vars = malloc(sizeof(String*));
-        vars[0] = string_new_c(value->data);
+// resolve type name of a declaration
+static void var_type(il_view_t type, il_var_decl_t *decl) {
+    for (uint32_t n = 0; n < sizeof(var_types) / sizeof(var_types[0]); n++) {
+        if (view_equals_nocase(type, var_types[n].name)) {
+            decl->datatype = var_types[n].datatype;
+            decl->size = var_types[n].size;
+            decl->align = var_types[n].align;
+            return;
+        }
     }
 
-    for (uint32_t n = 0; n < vars_qty; n++) {
-        if ((pos = string_find_c(vars[n], "=", 0)) != STR_ERROR) {
-            String left = string_left(vars[n], pos - 1);
-            String right = string_right(vars[n], pos + 1);
+    decl->datatype = IEC_T_USER;
+    decl->size = 0;
+    decl->align = 0;
+}
 
-            uint32_t vq;
-            String *vr = NULL;
+static void parse_vad(il_view_t value, il_t **result, il_arena_t *arena, il_symbols_t *symbols) {
+    uint32_t pos, eq;
+    il_view_t vars, names, name, type;
+    il_var_decl_t *decl;
 
-            if ((vq = string_split_array(left, ",", &vr)) == 0) {
-                vq = 1;
-                vr = malloc(sizeof(String*));
-                vr[0] = string_new_c(left->data);
-            }
+    if ((pos = view_find(value, "END_VAR")) != STR_ERROR)
+        value = view_left(value, pos);
+    value = view_trim(value);
 
-            for (uint32_t r = 0; r < vq; r++) {
-                (*result)->data.vad.var = realloc((*result)->data.vad.var, ((*result)->data.vad.len + 1) * sizeof(String));
-                (*result)->data.vad.value = realloc((*result)->data.vad.value, ((*result)->data.vad.len + 1) * sizeof(String));
+    (*result)->data.vad.len = 0;
+    (*result)->data.vad.var = NULL;
 
-                (*result)->data.vad.var[(*result)->data.vad.len] = string_new_c(vr[r]->data);
-                (*result)->data.vad.value[(*result)->data.vad.len] = string_new_c(right->data);
-                DBG_PRINT("        [%s : %s]\n",
-                        (*result)->data.vad.var[(*result)->data.vad.len]->data,
-                        (*result)->data.vad.value[(*result)->data.vad.len]->data
-                );
+    // one block for all declarations (upper bound: one per ',' and '=')
+    if (value.len > 0)
+        (*result)->data.vad.var = il_arena_alloc(arena, (view_count_unquoted(value, ',') + view_count_unquoted(value, '=')) * sizeof(il_var_decl_t));
 
-                ++(*result)->data.vad.len;
+    while (value.len > 0) {
+        pos = view_find(value, " ");
+        vars = view_left(value, pos);
+        value = view_right(value, pos == STR_ERROR ? value.len : pos + 1);
 
-                free(vr[r]);
-            }
-            free(vr);
-            free(left);
-            free(right);
+        if ((eq = view_find(vars, "=")) == STR_ERROR)
+            continue;
+        names = view_left(vars, eq);
+        type = view_right(vars, eq + 1);
+
+        while (names.len > 0) {
+            pos = view_find(names, ",");
+            name = view_left(names, pos);
+            names = view_right(names, pos == STR_ERROR ? names.len : pos + 1);
+            if (name.len == 0)
+                continue;
+
+            decl = &((*result)->data.vad.var[(*result)->data.vad.len++]);
+            decl->name = view_symbol_id(arena, symbols, name, &(decl->name_id));
+            decl->type = view_symbol_id(arena, symbols, type, &(decl->type_id));
+            var_type(type, decl);
         }
-        free(vars[n]);
     }
-    free(vars);
 }
 
 //////////////////////////////////////////////////////////////
 
-static void parse_literal(String value, il_dataformat_t lit_dataformat, il_t **result) {
+static bool parse_literal(il_view_t value, il_dataformat_t lit_dataformat, il_t **result, il_arena_t *arena, il_symbols_t *symbols, il_error_t *error) {
     switch (lit_dataformat) {
         case LIT_BOOLEAN:
-            parse_boolean(value, &((*result)));
-            DBG_PRINT("        [boolean: %d]\n", (*result)->data.boolean);
-
-            break;
+            return parse_boolean(value, result, error);
         case LIT_DURATION:
-            parse_duration(value, &((*result)));
-            DBG_PRINT("        [H: %d, M: %d, S: %d, MS: %d]\n",
-                    (*result)->data.tod.hour,
-                    (*result)->data.tod.min,
-                    (*result)->data.tod.sec,
-                    (*result)->data.tod.msec
-                    );
-
-            break;
+            return parse_duration(value, result, error);
         case LIT_DATE:
-            parse_date(value, &((*result)));
-            DBG_PRINT("        [year: %d, month: %d, day: %d]\n",
-                    (*result)->data.date.year,
-                    (*result)->data.date.month,
-                    (*result)->data.date.day
-                    );
-            break;
+            return parse_date(value, result, error);
         case LIT_TIME_OF_DAY:
-            parse_time_of_day(value, &((*result)));
-            DBG_PRINT("        [H: %d, M: %d, S: %d, MS: %d]\n",
-                    (*result)->data.tod.hour, (*result)->data.tod.min,
-                    (*result)->data.tod.sec,
-                    (*result)->data.tod.msec
-                    );
-
-            break;
+            return parse_time_of_day(value, result, error);
         case LIT_DATE_AND_TIME:
-            parse_date_and_time(value, &((*result)));
-            DBG_PRINT("        [year: %d, month: %d, day: %d, ",
-                    (*result)->data.dt.date.year, (*result)->data.dt.date.month,
-                    (*result)->data.dt.date.day
-                    );
-            DBG_PRINT("H: %d, M: %d, S: %d, MS: %d]\n",
-                    (*result)->data.dt.tod.hour,
-                    (*result)->data.dt.tod.min,
-                    (*result)->data.dt.tod.sec,
-                    (*result)->data.dt.tod.msec
-                    );
-            break;
+            return parse_date_and_time(value, result, error);
         case LIT_INTEGER:
-            parse_integer(value, &((*result)));
-            DBG_PRINT("        [integer: %" PRId64 "]\n", (*result)->data.integer);
-            break;
+            return parse_integer(value, result, error);
         case LIT_REAL:
-            parse_real(value, &((*result)));
-            DBG_PRINT("        [real: %f]\n", (*result)->data.real);
-            break;
         case LIT_REAL_EXP:
-            parse_real_exp(value, &((*result)));
-            DBG_PRINT("        [real: %f]\n", (*result)->data.real);
-            break;
+            return parse_real(value, lit_dataformat, result, error);
         case LIT_BASE2:
         case LIT_BASE8:
         case LIT_BASE16:
-            parse_base(value, &((*result)));
-            DBG_PRINT("        [integer: %" PRId64 "]\n", (*result)->data.integer);
-            break;
+            return parse_base(value, result, error);
         case LIT_PHY:
-            parse_phy(value, &((*result)));
-            DBG_PRINT("        [prefix: %d[%c], datatype: %d[%c] ",
-                    (*result)->data.phy.prefix,
-                    phy_prefix_c[(*result)->data.phy.prefix],
-                    (*result)->data.phy.datatype,
-                    phy_data_type_c[(*result)->data.phy.datatype]
-                                    );
-#ifdef DEBUG
-            switch ((*result)->data.phy.datatype) {
-                case PHY_D_BIT:
-                    DBG_PRINT("phy_a: %d, phy_b: %d]\n",
-                            (*result)->data.phy.data.bit.phy_a,
-                            (*result)->data.phy.data.bit.phy_b
-                            );
-                    break;
-                case PHY_D_BYTE:
-                    DBG_PRINT("phy_byte: %d]\n", (*result)->data.phy.data.byte);
-                    break;
-                case PHY_D_WORD:
-                    DBG_PRINT("phy_word: %d]\n", (*result)->data.phy.data.word);
-                    break;
-                case PHY_D_DOUBLE:
-                    DBG_PRINT("phy_double: %f]\n", (*result)->data.phy.data.dbl);
-            }
-#endif
-            break;
+            return parse_phy(value, result, error);
         case LIT_STRING:
-            parse_string(value, &((*result)));
-            DBG_PRINT("        [string: %s]\n", (*result)->data.str->data);
+            parse_string(value, result, arena);
             break;
         case LIT_VAR:
-            (*result)->data.str = string_new_c(value->data);
-            DBG_PRINT("        [variable: %s]\n", (*result)->data.str->data);
-            break;
-        case LIT_CAL:
-            parse_cal(value, &((*result)));
+            (*result)->data.str = view_symbol(arena, symbols, value);
             break;
         case LIT_VAD:
-            parse_vad(value, &((*result)));
-            (*result)->data.vad.output = 0;
-            DBG_PRINT("          [is_output: %d]\n", (*result)->data.vad.output);
-
+            parse_vad(value, result, arena, symbols);
             break;
         case LIT_VAO:
-            parse_vad(value, &((*result)));
-            (*result)->data.vad.output = 1;
+            parse_vad(value, result, arena, symbols);
             (*result)->lit_dataformat = LIT_VAD;
-            DBG_PRINT("          [is_output: %d]\n", (*result)->data.vad.output);
+            break;
+        default:
             break;
     }
+
+    return true;
 }
 
 ///////////////////////////////////////////////////////////////
 
-////////////////////// parse commands /////////////////////////
+/////////////////////////// labels ////////////////////////////
 
-void parse_command(String line, il_t **result) {
-    String left = NULL, right = NULL;
+static uint8_t labels_key[16] = { 'i', 'l', '_', 'p', 'a', 'r', 's', 'e', 'r', '_', 'l', 'a', 'b', 'e', 'l' };
 
-    string_trim_m(line);
-    uint32_t spc = string_find_c(line, " ", 0);
+static uint32_t label_hash(il_view_t name) {
+    string_hash_t hash = string_hash_c(name.ptr, name.len, HSIP32, labels_key);
 
-    if (spc == STR_ERROR) {
-        left = string_new_c(line->data);
-        right = string_new_c("-");
-    } else {
-        left = string_left(line, spc - 1);
-        right = string_right(line, spc + 1);
+    return hash.out[0] | hash.out[1] << 8 | hash.out[2] << 16 | (uint32_t) hash.out[3] << 24;
+}
+
+static void labels_init(il_labels_t *labels) {
+    labels->qty = 0;
+    labels->cap = 64;
+    labels->index = il_calloc(labels->cap, sizeof(uint32_t));
+    labels->label = il_malloc((labels->cap / 2) * sizeof(il_label_t));
+}
+
+// hash table slot of label name (empty slot if not exist)
+static uint32_t* labels_slot(il_labels_t *labels, const char *name, uint32_t len, uint32_t hash) {
+    uint32_t n = hash & (labels->cap - 1);
+    il_label_t *lbl;
+
+    while (labels->index[n] != 0) {
+        lbl = &(labels->label[labels->index[n] - 1]);
+        if (lbl->hash == hash && lbl->label->length == len && !memcmp(lbl->label->data, name, len))
+            break;
+        n = (n + 1) & (labels->cap - 1);
     }
 
-    string_toupper_m(right);
-    string_trim_m(left);
-    string_trim_m(right);
+    return &(labels->index[n]);
+}
 
-    (*result)->code = STR_ERROR;
+// position of label in labels, added as not defined if not exist
+static uint32_t labels_entry(il_labels_t *labels, il_view_t name) {
+    uint32_t hash = label_hash(name);
+    uint32_t *slot = labels_slot(labels, name.ptr, name.len, hash);
+    uint32_t pos;
+
+    if (*slot != 0)
+        return *slot - 1;
+
+    pos = labels->qty;
+    labels->label[pos].label = view_string(NULL, name);
+    labels->label[pos].hash = hash;
+    labels->label[pos].line = STR_ERROR;
+    labels->label[pos].pending = 0;
+    labels->label[pos].last = 0;
+    *slot = ++labels->qty;
+
+    // keep load factor under 1/2
+    if (labels->qty == labels->cap / 2) {
+        il_free(labels->index);
+        labels->cap *= 2;
+        labels->index = il_calloc(labels->cap, sizeof(uint32_t));
+        labels->label = il_realloc(labels->label, (labels->cap / 2) * sizeof(il_label_t));
+
+        for (uint32_t n = 0; n < labels->qty; n++) {
+            il_label_t *lbl = &(labels->label[n]);
+            *labels_slot(labels, lbl->label->data, lbl->label->length, lbl->hash) = n + 1;
+        }
+    }
+
+    return pos;
+}
+
+///////////////////////////////////////////////////////////////
+
+////////////////////// parse commands /////////////////////////
+
+static uint32_t parse_command(const il_str_t *cmd, il_view_t operand, il_t **result) {
+    il_literal_t lit;
+
+    (*result)->code = IL_CAI;
     (*result)->lit_dataformat = LIT_NONE;
     (*result)->iec_datatype = IEC_T_NULL;
     (*result)->c = 0;
     (*result)->n = 0;
     (*result)->p = 0;
 
-    for (uint32_t cmd = 0; cmd < 58; cmd++) {
-        if (string_equals_c(left, commands[cmd].str)) {
-            (*result)->code = commands[cmd].code;
-            (*result)->c = commands[cmd].c;
-            (*result)->n = commands[cmd].n;
-            (*result)->p = commands[cmd].p;
-            break;
-        }
+    if (cmd != NULL) {
+        (*result)->code = cmd->code;
+        (*result)->c = cmd->c;
+        (*result)->n = cmd->n;
+        (*result)->p = cmd->p;
     }
 
-    if ((*result)->code == STR_ERROR)
-        (*result)->code = IL_CAI;
-
-    if((*result)->code == 55)
-        goto end;
+    if (operand.len == 0)
+        return 0;
 
     if ((*result)->code != IL_JMP && (*result)->code != IL_CAL && (*result)->code != IL_CAI && (*result)->code != IL_POP && (*result)->code != IL_S) {
-        (*result)->lit_dataformat = identify_lit_dataformat(right);
-        (*result)->iec_datatype = identify_iec_datatype(right);
+        lit = identify_literal(operand);
+        (*result)->lit_dataformat = lit.format;
+        (*result)->iec_datatype = lit.type;
+        return lit.payload;
     }
 
-    end:
-    free(left);
-    free(right);
+    return 0;
 }
 
 ///////////////////////////////////////////////////////////////
@@ -1241,156 +1530,853 @@ void parse_command(String line, il_t **result) {
 
 //////////////////////// free elements ////////////////////////
 
-static void free_labels(il_label_t **il_labels, int labels_qty) {
-    for (uint32_t lbl = 0; lbl < labels_qty; lbl++) {
-        free((*il_labels)[lbl].label);
+static void free_labels(il_labels_t *labels) {
+    for (uint32_t lbl = 0; lbl < labels->qty; lbl++) {
+        string_free(labels->label[lbl].label);
     }
-    free(*il_labels);
+    il_free(labels->label);
+    il_free(labels->index);
 }
 
-static void free_program(String **program, int program_lines) {
-    for (uint32_t line = 0; line < program_lines; line++) {
-        free((*program)[line]);
-    }
-    free(*program);
-}
-
-void free_il(il_t **il) {
-    if (*il == NULL || il == NULL)
-        return;
-
-    switch ((*il)->lit_dataformat) {
+// heap memory referenced by instruction (not instruction itself)
+static void free_il_data(il_t *il) {
+    switch (il->lit_dataformat) {
         case LIT_STRING:
         case LIT_VAR:
-            free((*il)->data.str);
+            string_free(il->data.str);
             break;
         case LIT_CAL:
-            for (uint32_t n = 0; n < (*il)->data.cal.len; n++) {
-                free((*il)->data.cal.var[n]);
-                if ((*il)->data.cal.value[n].lit_dataformat == LIT_STRING || (*il)->data.cal.value[n].lit_dataformat == LIT_VAR)
-                    free((*il)->data.cal.value[n].data.str);
+            for (uint32_t n = 0; n < il->data.cal.len; n++) {
+                string_free(il->data.cal.arg[n].var);
+                if (il->data.cal.arg[n].value.lit_dataformat == LIT_STRING || il->data.cal.arg[n].value.lit_dataformat == LIT_VAR)
+                    string_free(il->data.cal.arg[n].value.data.str);
             }
-            free((*il)->data.cal.in_out);
-            free((*il)->data.cal.func);
-            free((*il)->data.cal.var);
-            free((*il)->data.cal.value);
+            string_free(il->data.cal.func);
+            il_free(il->data.cal.arg);
             break;
         case LIT_VAD:
-            for (uint32_t n = 0; n < (*il)->data.vad.len; n++) {
-                free((*il)->data.vad.value[n]);
-                free((*il)->data.vad.var[n]);
+            for (uint32_t n = 0; n < il->data.vad.len; n++) {
+                string_free(il->data.vad.var[n].type);
+                string_free(il->data.vad.var[n].name);
             }
-            free((*il)->data.vad.value);
-            free((*il)->data.vad.var);
+            il_free(il->data.vad.var);
             break;
     }
+}
 
-    free(*il);
+void free_il(il_t **il) {
+    if (il == NULL || *il == NULL)
+        return;
+
+    free_il_data(*il);
+    il_free(*il);
 }
 
 ///////////////////////////////////////////////////////////////
 
-void parse_file_il(char *file, parsed_il_t *parsed) {
-    il_label_t *il_labels = NULL;
-    uint32_t labels_qty = 0, program_lines = 0;
-    String *program = NULL;
-    String value;
-    uint32_t line;
-
-    // program loading and conditioning
-    program_lines = load_file(file, &program);
-    labels_qty = find_labels(&il_labels, &program, program_lines);
-    delete_comments(&program, program_lines);
-    sustitute_labels(&il_labels, labels_qty, &program, program_lines);
-    sustitute_others(&program, program_lines);
-    free_labels(&il_labels, labels_qty);
-    // ////////////////////////////////
-
-    parsed->result = malloc(sizeof(il_t*));
-    // parse program
-    for (line = 0; line < program_lines; line++) {
-
-        parsed->result = realloc(parsed->result, (line + 1) * sizeof(il_t*));
-        parsed->result[line] = malloc(sizeof(il_t));
-
-        DBG_PRINT("[%04d] %s\n", line, program[line]->data);
-
-        parse_command(program[line], &(parsed->result[line]));
-        if (parsed->result[line]->code == IL_CAL || parsed->result[line]->code == IL_CAI)
-            parsed->result[line]->lit_dataformat = LIT_CAL;
-
-        if (parsed->result[line]->code == IL_VAD)
-            parsed->result[line]->lit_dataformat = LIT_VAD;
-        if (parsed->result[line]->code == IL_VAO) {
-            parsed->result[line]->lit_dataformat = LIT_VAO;
-            parsed->result[line]->code = IL_VAD;
-        }
+static bool parse_instruction(const il_str_t *cmd, il_view_t opcode, il_view_t operand, uint32_t line, il_t **result, il_arena_t *arena, il_symbols_t *symbols, const il_listener_t *listener, il_error_t *error) {
+    uint32_t payload, pos;
+    bool ok;
 
-        DBG_PRINT("    [code: %d(0x%02x)[%s], conditional: %d, negate: %d, push: %d, lit_dataformat: %s, iec_datatype: %s]\n",
-                parsed->result[line]->code,
-                parsed->result[line]->code,
-                il_commands_str[parsed->result[line]->code],
-                parsed->result[line]->c,
-                parsed->result[line]->n,
-                parsed->result[line]->p,
-                lit_dataformat_str[parsed->result[line]->lit_dataformat],
-                pfx_iectype[parsed->result[line]->iec_datatype]
-                );
-
-        if (parsed->result[line]->code != IL_CAI)
-            value = string_right(program[line], string_find_c(program[line], " ", 0) + 1);
-        else {
-            value = string_new_c(program[line]->data);
-            parsed->result[line]->code = IL_CAL;
-        }
+    payload = parse_command(cmd, operand, result);
 
-        if (parsed->result[line]->code != IL_CAL) {
-            uint32_t spc = string_find_c(value, "#", 0);
-            string_right_m(value, spc + 1);
-        }
+    if ((*result)->code == IL_CAL || (*result)->code == IL_CAI)
+        (*result)->lit_dataformat = LIT_CAL;
+
+    // variables definition: section is kept in vad, code is always IL_VAD
+    if ((*result)->code == IL_VAD || (*result)->code == IL_VAI || (*result)->code == IL_VAO) {
+        (*result)->lit_dataformat = (*result)->code == IL_VAO ? LIT_VAO : LIT_VAD;
+        (*result)->data.vad.section = (*result)->code == IL_VAO ? IL_VAR_OUTPUT : (*result)->code == IL_VAI ? IL_VAR_INPUT : IL_VAR_LOCAL;
+        (*result)->code = IL_VAD;
+    }
+
+    IL_EMIT(listener, instruction, line, opcode.ptr, operand.ptr, *result);
+
+    // jump target is resolved by caller
+    if ((*result)->code == IL_JMP) {
+        (*result)->data.jmp_addr = 0;
+        return true;
+    }
+
+    // operand is parsed in place in the lexer text buffer
+    if ((*result)->code == IL_CAI) {
+        (*result)->code = IL_CAL;
+        ok = parse_cal(opcode, operand, result, arena, symbols, listener, error);
+    } else if ((*result)->code == IL_CAL) {
+        pos = view_find(operand, " ");
+        ok = parse_cal(view_left(operand, pos), view_right(operand, pos == STR_ERROR ? operand.len : pos + 1), result, arena, symbols, listener, error);
+    } else {
+        operand = view_right(operand, payload);
 
         if (
-                parsed->result[line]->lit_dataformat != LIT_STRING &&
-                parsed->result[line]->lit_dataformat != LIT_VAR    &&
-                parsed->result[line]->lit_dataformat != LIT_CAL    &&
-                parsed->result[line]->lit_dataformat != LIT_VAD    &&
-                parsed->result[line]->lit_dataformat != LIT_VAO
+                (*result)->lit_dataformat != LIT_STRING &&
+                (*result)->lit_dataformat != LIT_VAR    &&
+                (*result)->lit_dataformat != LIT_VAD    &&
+                (*result)->lit_dataformat != LIT_VAO    &&
+                !literal_numeric((*result)->lit_dataformat)
            )
         {
-            string_toupper_m(value);
-            while(string_find_c(value, "_", 0) != STR_ERROR) {
-                string_delete_c_m(value, "_");
-            }
+            view_toupper(operand);
+            operand = view_delete_c(operand, '_');
+        }
+
+        ok = parse_literal(operand, (*result)->lit_dataformat, result, arena, symbols, error);
+    }
+
+    if (ok && (*result)->lit_dataformat != LIT_NONE)
+        IL_EMIT(listener, literal, *result, IL_NO_ARG);
+
+    return ok;
+}
+
+///////////////////////// iterator ////////////////////////////
+
+struct il_parser_s {
+     il_lexer_t lexer;        //
+     const char *map;         // mapped file (NULL if source is a caller buffer)
+         size_t map_len;      //
+    il_labels_t labels;       //
+     il_fixup_t *pending;     // jumps to labels not yet defined when parsed (chained by label)
+       uint32_t pending_qty;  //
+       uint32_t pending_cap;  //
+      il_jump_t *resolved;    // resolved jumps not yet returned by il_parser_fixup
+       uint32_t resolved_qty; //
+       uint32_t resolved_pos; //
+       uint32_t resolved_cap; //
+      il_diag_t *diag;        // diagnostics
+       uint32_t diag_qty;     //
+       uint32_t diag_cap;     //
+       uint32_t line;         // next instruction index
+           bool end;          // IL_END returned
+    const il_listener_t *listener; // events
+             il_arena_t *arena;    // instructions memory (NULL: heap)
+           il_symbols_t *symbols;  // identifiers (NULL: not interned)
+                   il_t *slot;     // storage of next instruction (NULL: allocate it)
+         il_mem_stats_t mem;       // memory used by parser and instructions
+};
+
+static void diag_add(il_parser_t *parser, uint32_t line, uint32_t column, const char *message, il_view_t value) {
+    il_diag_t *diag;
+
+    if (parser->diag_qty == parser->diag_cap) {
+        parser->diag_cap = parser->diag_cap == 0 ? 8 : parser->diag_cap * 2;
+        parser->diag = il_realloc(parser->diag, parser->diag_cap * sizeof(il_diag_t));
+    }
+
+    diag = &(parser->diag[parser->diag_qty++]);
+    diag->line = line;
+    diag->column = column;
+    diag->message = string_new(strlen(message) + value.len + 3);
+    if (value.len > 0)
+        string_write(diag->message, "%s [" VIEW_FMT "]", message, VIEW_ARG(value));
+    else
+        string_write(diag->message, "%s", message);
+
+    IL_EMIT(parser->listener, diag, diag);
+}
+
+static int diag_cmp(const void *a, const void *b) {
+    const il_diag_t *da = a, *db = b;
+
+    if (da->line != db->line)
+        return (da->line > db->line) - (da->line < db->line);
+
+    return (da->column > db->column) - (da->column < db->column);
+}
+
+static il_t* new_instruction(il_parser_t *parser) {
+    if (parser->slot != NULL)
+        return parser->slot;
+
+    return il_arena_alloc(parser->arena, sizeof(il_t));
+}
+
+static il_t* instruction_init(il_t *instruction, il_commands_t code) {
+    instruction->code = code;
+    instruction->iec_datatype = IEC_T_NULL;
+    instruction->lit_dataformat = LIT_NONE;
+    instruction->c = 0;
+    instruction->n = 0;
+    instruction->p = 0;
+
+    return instruction;
+}
+
+static void jump_resolved(il_parser_t *parser, uint32_t line, uint32_t jmp_addr) {
+    IL_EMIT(parser->listener, jump, line, jmp_addr);
+
+    if (parser->resolved_qty == parser->resolved_cap) {
+        parser->resolved_cap *= 2;
+        parser->resolved = il_realloc(parser->resolved, parser->resolved_cap * sizeof(il_jump_t));
+    }
+
+    parser->resolved[parser->resolved_qty].line = line;
+    parser->resolved[parser->resolved_qty].jmp_addr = jmp_addr;
+    ++parser->resolved_qty;
+}
+
+// first definition of a duplicated label is used
+static void label_define(il_parser_t *parser, il_view_t name) {
+    il_label_t *lbl = &(parser->labels.label[labels_entry(&(parser->labels), name)]);
+
+    IL_EMIT(parser->listener, label, name.ptr, name.len, parser->line);
+
+    if (lbl->line != STR_ERROR)
+        return;
+
+    lbl->line = parser->line;
+    for (uint32_t n = lbl->pending; n != 0; n = parser->pending[n - 1].next)
+        jump_resolved(parser, parser->pending[n - 1].line, lbl->line);
+    lbl->pending = lbl->last = 0;
+}
+
+static void jump_define(il_parser_t *parser, il_view_t name, il_token_t *tok, il_t *instruction) {
+    uint32_t pos;
+    il_label_t *lbl;
+    long n = 0;
+
+    // absolute address
+    if (!view_issigned(name) && (name.len == 0 || (n = view_tolong(name, 10)) != LONG_MAX)) {
+        instruction->data.jmp_addr = n;
+        IL_EMIT(parser->listener, jump, parser->line, instruction->data.jmp_addr);
+        return;
+    }
+
+    pos = labels_entry(&(parser->labels), name);
+    lbl = &(parser->labels.label[pos]);
+    if (lbl->line != STR_ERROR) {
+        instruction->data.jmp_addr = lbl->line;
+        IL_EMIT(parser->listener, jump, parser->line, lbl->line);
+        return;
+    }
+
+    // chained to label, resolved by label_define
+    instruction->data.jmp_addr = STR_ERROR;
+    if (parser->pending_qty == parser->pending_cap) {
+        parser->pending_cap *= 2;
+        parser->pending = il_realloc(parser->pending, parser->pending_cap * sizeof(il_fixup_t));
+    }
+    parser->pending[parser->pending_qty].label = pos;
+    parser->pending[parser->pending_qty].next = 0;
+    parser->pending[parser->pending_qty].line = parser->line;
+    parser->pending[parser->pending_qty].src_line = tok->line;
+    parser->pending[parser->pending_qty].src_column = tok->column;
+    if (lbl->last != 0)
+        parser->pending[lbl->last - 1].next = parser->pending_qty + 1;
+    else
+        lbl->pending = parser->pending_qty + 1;
+    lbl->last = ++parser->pending_qty;
+}
+
+// jumps to labels never defined, in source order (pending is in source order)
+static void labels_missing(il_parser_t *parser) {
+    for (uint32_t n = 0; n < parser->pending_qty; n++) {
+        il_fixup_t *fixup = &(parser->pending[n]);
+        il_label_t *lbl = &(parser->labels.label[fixup->label]);
+
+        if (lbl->line == STR_ERROR)
+            diag_add(parser, fixup->src_line, fixup->src_column, "label not found",
+                    (il_view_t){ lbl->label->data, lbl->label->length });
+    }
+    parser->pending_qty = 0;
+}
+
+/**
+ * @fn il_parser_t* il_parser_open_buffer(const char *src, size_t len)
+ * @brief Open a memory buffer for instruction by instruction parsing.
+ *        Buffer is lexed in place and must remain valid and unmodified until il_parser_close
+ *
+ * @param src Source buffer (does not need to be null terminated)
+ * @param len Source length
+ * @param listener Events listener (NULL: none)
+ * @return Parser (NULL if source is too long)
+ */
+il_parser_t* il_parser_open_buffer(const char *src, size_t len, const il_listener_t *listener) {
+    il_mem_stats_t mem = { 0 }, *stats;
+    il_mem_phase_t phase;
+    il_parser_t *parser;
+
+    if (len > UINT32_MAX)
+        return NULL;
+
+    stats = il_mem_bind(&mem);
+    phase = il_mem_phase(IL_MEM_LOAD);
+
+    parser = il_malloc(sizeof(il_parser_t));
+    il_lexer_init(&(parser->lexer), src, len);
+    labels_init(&(parser->labels));
+
+    parser->map = NULL;
+    parser->map_len = 0;
+    parser->pending_qty = 0;
+    parser->pending_cap = 16;
+    parser->pending = il_malloc(parser->pending_cap * sizeof(il_fixup_t));
+    parser->resolved_qty = parser->resolved_pos = 0;
+    parser->resolved_cap = 16;
+    parser->resolved = il_malloc(parser->resolved_cap * sizeof(il_jump_t));
+    parser->diag = NULL;
+    parser->diag_qty = parser->diag_cap = 0;
+    parser->line = 0;
+    parser->end = false;
+    parser->listener = listener;
+    parser->lexer.listener = listener;
+    parser->arena = NULL;
+    parser->symbols = NULL;
+    parser->slot = NULL;
+
+    il_mem_phase(phase);
+    il_mem_bind(stats);
+    parser->mem = mem;
+
+    return parser;
+}
+
+/**
+ * @fn il_parser_t* il_parser_open(char *file)
+ * @brief Open file for instruction by instruction parsing. File is mapped and lexed in place
+ *
+ * @param file File name
+ * @param listener Events listener (NULL: none)
+ * @return Parser (NULL if file can't be opened)
+ */
+il_parser_t* il_parser_open(char *file, const il_listener_t *listener) {
+    il_parser_t *parser;
+    const char *src;
+    size_t len;
+
+    if ((src = map_file(file, &len)) == NULL)
+        return NULL;
+
+    if ((parser = il_parser_open_buffer(src, len, listener)) == NULL) {
+        munmap((void*) src, len);
+        return NULL;
+    }
+    IL_EMIT(listener, source, file);
+
+    if (len > 0) {
+        parser->map = src;
+        parser->map_len = len;
+    }
+
+    return parser;
+}
+
+/**
+ * @fn void il_parser_arena(il_parser_t *parser, il_arena_t *arena)
+ * @brief Allocate next instructions from arena instead of heap.
+ *        They are released with il_arena_free and must not be freed with free_il
+ *
+ * @param parser Parser
+ * @param arena Arena (owned by caller, NULL: heap)
+ */
+void il_parser_arena(il_parser_t *parser, il_arena_t *arena) {
+    parser->arena = arena;
+}
+
+/**
+ * @fn void il_parser_symbols(il_parser_t *parser, il_symbols_t *symbols)
+ * @brief Intern identifiers of next instructions (variables, CAL function and arguments, VAR names and types).
+ *        Instructions share the names of the symbols table, use it with an arena (il_parser_arena) instead of free_il
+ *
+ * @param parser Parser
+ * @param symbols Symbols (owned by caller, NULL: not interned)
+ */
+void il_parser_symbols(il_parser_t *parser, il_symbols_t *symbols) {
+    parser->symbols = symbols;
+}
+
+static bool parser_next(il_parser_t *parser, il_t **instruction) {
+    const il_str_t *cmd = NULL;
+    il_view_t opcode = { NULL, 0 }, operand = { NULL, 0 };
+    il_token_t tok, operand_tok = { 0 };
+    il_error_t error = { NULL };
+    bool failed = false;
+
+    if (parser->end)
+        return false;
+
+    while (il_lexer_next(&(parser->lexer), &tok)) {
+        switch (tok.kind) {
+            case IL_TK_LABEL:
+                il_mem_phase(IL_MEM_LABELS);
+                label_define(parser, il_lexer_view(&(parser->lexer), &tok));
+                il_mem_phase(IL_MEM_LEXER);
+                break;
+            case IL_TK_OPCODE:
+                cmd = tok.cmd;
+                opcode = il_lexer_view(&(parser->lexer), &tok);
+                operand = (il_view_t){ opcode.ptr + opcode.len, 0 };
+                operand_tok = tok;
+                break;
+            case IL_TK_OPERAND:
+                operand = il_lexer_view(&(parser->lexer), &tok);
+                operand_tok = tok;
+                break;
+            case IL_TK_ERROR:
+                diag_add(parser, tok.line, tok.column, parser->lexer.error, il_lexer_view(&(parser->lexer), &tok));
+                failed = true;
+                break;
+            case IL_TK_EOL:
+                il_mem_phase(IL_MEM_LITERALS);
+                *instruction = new_instruction(parser);
+                if (!failed && !parse_instruction(cmd, opcode, operand, parser->line, instruction, parser->arena, parser->symbols, parser->listener, &error)) {
+                    diag_add(parser, operand_tok.line, operand_tok.column, error.message, error.value);
+                    if (parser->arena == NULL)
+                        free_il_data(*instruction);
+                    failed = true;
+                }
+
+                if (failed)
+                    instruction_init(*instruction, IL_NOP);
+                else if ((*instruction)->code == IL_JMP && operand.len > 0) {
+                    il_mem_phase(IL_MEM_LABELS);
+                    jump_define(parser, operand, &operand_tok, *instruction);
+                }
+
+                IL_EMIT(parser->listener, parsed, parser->line, *instruction);
+                ++parser->line;
+                return true;
         }
+    }
+
+    // end of program
+    il_mem_phase(IL_MEM_LABELS);
+    labels_missing(parser);
+
+    il_mem_phase(IL_MEM_LITERALS);
+    *instruction = instruction_init(new_instruction(parser), IL_END);
+    IL_EMIT(parser->listener, instruction, parser->line, "END", "", *instruction);
+    IL_EMIT(parser->listener, parsed, parser->line, *instruction);
+
+    ++parser->line;
+    parser->end = true;
+
+    return true;
+}
+
+/**
+ * @fn bool il_parser_next(il_parser_t *parser, il_t **instruction)
+ * @brief Parse next instruction (last one is IL_END).
+ *        A jump to a label not yet defined has jmp_addr = STR_ERROR until it is returned by il_parser_fixup.
+ *        An instruction with errors is returned as IL_NOP (instruction indexes are kept) and reported in diagnostics
+ *
+ * @param parser Parser
+ * @param instruction Parsed instruction (owned by caller, free with free_il if parser has no arena)
+ * @return false if there are no more instructions
+ */
+bool il_parser_next(il_parser_t *parser, il_t **instruction) {
+    il_mem_stats_t *stats = il_mem_bind(&(parser->mem));
+    il_mem_phase_t phase = il_mem_phase(IL_MEM_LEXER);
+    bool next = parser_next(parser, instruction);
+
+    il_mem_phase(phase);
+    il_mem_bind(stats);
+
+    return next;
+}
+
+/**
+ * @fn bool il_parser_fixup(il_parser_t *parser, uint32_t *line, uint32_t *jmp_addr)
+ * @brief Get a jump resolved since it was returned by il_parser_next (call until false after each il_parser_next)
+ *
+ * @param parser Parser
+ * @param line Instruction index of jump
+ * @param jmp_addr Resolved address
+ * @return false if there are no more resolved jumps
+ */
+bool il_parser_fixup(il_parser_t *parser, uint32_t *line, uint32_t *jmp_addr) {
+    if (parser->resolved_pos == parser->resolved_qty) {
+        parser->resolved_pos = parser->resolved_qty = 0;
+        return false;
+    }
+
+    *line = parser->resolved[parser->resolved_pos].line;
+    *jmp_addr = parser->resolved[parser->resolved_pos].jmp_addr;
+    ++parser->resolved_pos;
+
+    return true;
+}
+
+/**
+ * @fn const il_diag_t* il_parser_diag(il_parser_t *parser, uint32_t *qty)
+ * @brief Diagnostics found until now (valid until next il_parser_next or il_parser_close).
+ *        Jumps to undefined labels are reported when IL_END is returned
+ *
+ * @param parser Parser
+ * @param qty Number of diagnostics
+ * @return Diagnostics
+ */
+const il_diag_t* il_parser_diag(il_parser_t *parser, uint32_t *qty) {
+    *qty = parser->diag_qty;
+
+    return parser->diag;
+}
+
+/**
+ * @fn const il_mem_stats_t* il_parser_mem(const il_parser_t *parser)
+ * @brief Memory used by parser and instructions until now (instructions released by caller are not discounted)
+ *
+ * @param parser Parser
+ * @return Memory stats
+ */
+const il_mem_stats_t* il_parser_mem(const il_parser_t *parser) {
+    return &(parser->mem);
+}
+
+/**
+ * @fn void il_parser_close(il_parser_t *parser)
+ * @brief Close parser and free its resources (not returned instructions)
+ *
+ * @param parser Parser
+ */
+void il_parser_close(il_parser_t *parser) {
+    if (parser == NULL)
+        return;
+
+    for (uint32_t n = 0; n < parser->diag_qty; n++)
+        string_free(parser->diag[n].message);
+    il_free(parser->pending);
+    il_free(parser->resolved);
+    il_free(parser->diag);
+    free_labels(&(parser->labels));
+    il_lexer_free(&(parser->lexer));
+    if (parser->map != NULL)
+        munmap((void*) parser->map, parser->map_len);
+    il_free(parser);
+}
+
+///////////////////////////////////////////////////////////////
+
+// upper bound of instructions: one per source line plus IL_END
+static uint32_t count_lines(const char *src, uint32_t len) {
+    const char *end = src + len;
+    uint32_t lines = 2;
+
+    while (src < end && (src = memchr(src, '\n', end - src)) != NULL) {
+        ++lines;
+        ++src;
+    }
+
+    return lines;
+}
+
+static il_status_t parse_il(il_parser_t *parser, parsed_il_t *parsed) {
+    il_mem_stats_t *stats = il_mem_bind(&(parser->mem));
+    il_mem_phase_t phase = il_mem_phase(IL_MEM_LOAD);
+    il_t *instruction;
+    uint32_t line = 0, cap, jmp_line, jmp_addr;
+
+    il_arena_init(&(parsed->arena));
+    il_symbols_init(&(parsed->symbols), &(parsed->arena));
+    il_parser_arena(parser, &(parsed->arena));
+    il_parser_symbols(parser, &(parsed->symbols));
+
+    // instructions are parsed directly into a contiguous array
+    cap = count_lines(parser->lexer.src, parser->lexer.src_len);
+    parsed->code = il_malloc(cap * sizeof(il_t));
+
+    for (;;) {
+        if (line == cap) {
+            cap *= 2;
+            parsed->code = il_realloc(parsed->code, cap * sizeof(il_t));
+        }
+        parser->slot = &(parsed->code[line]);
+
+        if (!il_parser_next(parser, &instruction))
+            break;
+        ++line;
+
+        while (il_parser_fixup(parser, &jmp_line, &jmp_addr))
+            parsed->code[jmp_line].data.jmp_addr = jmp_addr;
+    }
+
+    if (line < cap)
+        parsed->code = il_realloc(parsed->code, line * sizeof(il_t));
+    parsed->result = il_malloc(line * sizeof(il_t*));
+    for (uint32_t n = 0; n < line; n++)
+        parsed->result[n] = &(parsed->code[n]);
+
+    // diagnostics are moved to result
+    if (parser->diag_qty > 0)
+        qsort(parser->diag, parser->diag_qty, sizeof(il_diag_t), diag_cmp);
+    parsed->diag = parser->diag;
+    parsed->diag_qty = parser->diag_qty;
+    parser->diag = NULL;
+    parser->diag_qty = 0;
+
+    // memory of parser is accounted until it is released
+    parsed->mem = parser->mem;
+    il_mem_bind(&(parsed->mem));
+    il_parser_close(parser);
+    il_mem_phase(phase);
+    il_mem_bind(stats);
+
+    parsed->lines = line;
+
+    return parsed->diag_qty == 0 ? IL_OK : IL_E_PARSE;
+}
+
+static il_status_t parse_open_error(parsed_il_t *parsed, const char *message, il_view_t value, const il_listener_t *listener) {
+    il_mem_stats_t *stats;
+    il_mem_phase_t phase;
+
+    memset(&(parsed->mem), 0, sizeof(il_mem_stats_t));
+    stats = il_mem_bind(&(parsed->mem));
+    phase = il_mem_phase(IL_MEM_LOAD);
+
+    il_arena_init(&(parsed->arena));
+    il_symbols_init(&(parsed->symbols), &(parsed->arena));
+    parsed->lines = 0;
+    parsed->code = NULL;
+    parsed->result = NULL;
+    parsed->diag_qty = 1;
+    parsed->diag = il_malloc(sizeof(il_diag_t));
+    parsed->diag->line = 0;
+    parsed->diag->column = 0;
+    parsed->diag->message = string_new(strlen(message) + value.len + 3);
+    string_write(parsed->diag->message, "%s [" VIEW_FMT "]", message, VIEW_ARG(value));
+
+    il_mem_phase(phase);
+    il_mem_bind(stats);
+
+    IL_EMIT(listener, diag, parsed->diag);
+
+    return IL_E_OPEN;
+}
+
+/**
+ * @fn il_status_t parse_file_il(char *file, parsed_il_t *parsed)
+ * @brief Parse a file. Parsing continues after errors, all of them are reported in diagnostics
+ *
+ * @param file File name
+ * @param parsed Result (free with free_parsed_il, also on errors)
+ * @param listener Events listener (NULL: none)
+ * @return Status
+ */
+il_status_t parse_file_il(char *file, parsed_il_t *parsed, const il_listener_t *listener) {
+    il_parser_t *parser;
+
+    if ((parser = il_parser_open(file, listener)) == NULL)
+        return parse_open_error(parsed, "can't open file", (il_view_t){ file, strlen(file) }, listener);
+
+    return parse_il(parser, parsed);
+}
+
+/**
+ * @fn il_status_t parse_buffer_il(const char *src, size_t len, parsed_il_t *parsed)
+ * @brief Parse a memory buffer. Parsing continues after errors, all of them are reported in diagnostics
+ *
+ * @param src Source buffer (does not need to be null terminated)
+ * @param len Source length
+ * @param parsed Result (free with free_parsed_il, also on errors)
+ * @param listener Events listener (NULL: none)
+ * @return Status
+ */
+il_status_t parse_buffer_il(const char *src, size_t len, parsed_il_t *parsed, const il_listener_t *listener) {
+    il_parser_t *parser;
+
+    if ((parser = il_parser_open_buffer(src, len, listener)) == NULL)
+        return parse_open_error(parsed, "source too long", (il_view_t){ "> 4 GiB", 8 }, listener);
 
-        parse_literal(value, parsed->result[line]->lit_dataformat, &(parsed->result[line]));
+    return parse_il(parser, parsed);
+}
+
+/**
+ * @fn void free_parsed_il(parsed_il_t *parsed)
+ * @brief Free instructions and diagnostics of a parse result
+ *
+ * @param parsed Result
+ */
+void free_parsed_il(parsed_il_t *parsed) {
+    il_symbols_free(&(parsed->symbols));
+    il_arena_free(&(parsed->arena));
+    for (uint32_t n = 0; n < parsed->diag_qty; n++)
+        string_free(parsed->diag[n].message);
+    il_free(parsed->code);
+    il_free(parsed->result);
+    il_free(parsed->diag);
+
+    parsed->lines = 0;
+    parsed->code = NULL;
+    parsed->result = NULL;
+    parsed->diag_qty = 0;
+    parsed->diag = NULL;
+}
+
+////////////////////// console listener ///////////////////////
+
+#define CONSOLE_OUT(ctx) ((ctx) != NULL ? (FILE*) (ctx) : stdout)
 
-        free(value);
-        DBG_PRINT("\n");
+static void console_source(void *ctx, const char *file) {
+    FILE *out = CONSOLE_OUT(ctx);
+
+    fprintf(out, "[FILE: %s]\n\n", file);
+}
+
+static void console_expansion(void *ctx, const il_expansion_t *exp) {
+    FILE *out = CONSOLE_OUT(ctx);
+
+    switch (exp->state) {
+        case IL_EXP_START:
+            fprintf(out, "[ start expanded (%s) ]\n    [ %s%s%.*s ]\n", exp->format == LIT_CAL ? "CAL" : "VAR", exp->opcode, exp->len > 0 ? " " : "",
+                    (int) exp->len, exp->text);
+            break;
+        case IL_EXP_LINE:
+            fprintf(out, "    [ %.*s ]\n", (int) exp->len, exp->text);
+            break;
+        case IL_EXP_END:
+            fprintf(out, "[ end expanded ]\n\n");
+            break;
     }
-    // /////////////
+}
 
-    parsed->result = realloc(parsed->result, (line + 1) * sizeof(il_t*));
-    parsed->result[line] = malloc(sizeof(il_t));
+static void console_label(void *ctx, const char *name, uint32_t len, uint32_t index) {
+    FILE *out = CONSOLE_OUT(ctx);
 
-    parsed->result[line]->code = IL_END;
-    parsed->result[line]->iec_datatype = IEC_T_NULL;
-    parsed->result[line]->lit_dataformat = LIT_NONE;
-    parsed->result[line]->c = 0;
-    parsed->result[line]->n = 0;
-    parsed->result[line]->p = 0;
-    DBG_PRINT("[%04d] END\n", line);
-    DBG_PRINT("    [code: %d(0x%02x)[%s], conditional: %d, negate: %d, push: %d, lit_dataformat: %s, iec_datatype: %s]\n\n",
-            parsed->result[line]->code,
-            parsed->result[line]->code,
-            il_commands_str[parsed->result[line]->code],
-            parsed->result[line]->c, parsed->result[line]->n,
-            parsed->result[line]->p,
-            lit_dataformat_str[parsed->result[line]->lit_dataformat],
-            pfx_iectype[parsed->result[line]->iec_datatype]
-             );
+    fprintf(out, "[LABEL: %.*s -> %04d]\n", (int) len, name, index);
+}
 
+static void console_instruction(void *ctx, uint32_t index, const char *opcode, const char *operand, const il_t *il) {
+    FILE *out = CONSOLE_OUT(ctx);
+
+    fprintf(out, "[%04d] %s%s%s\n", index, opcode, operand[0] != '\0' ? " " : "", operand);
+    fprintf(out, "    [code: %d(0x%02x)[%s], conditional: %d, negate: %d, push: %d, lit_dataformat: %s, iec_datatype: %s]\n",
+            il->code,
+            il->code,
+            il_commands_str[il->code],
+            il->c,
+            il->n,
+            il->p,
+            lit_dataformat_str[il->lit_dataformat],
+            pfx_iectype[il->iec_datatype]
+            );
+}
 
-    free_program(&program, program_lines);
-    parsed->lines = program_lines + 1;
+static void console_value(FILE *out, const il_t *il) {
+    switch (il->lit_dataformat) {
+        case LIT_BOOLEAN:
+            fprintf(out, "        [boolean: %d]\n", il->data.boolean);
+            break;
+        case LIT_DURATION:
+        case LIT_TIME_OF_DAY:
+            fprintf(out, "        [H: %d, M: %d, S: %d, MS: %d]\n", il->data.tod.hour, il->data.tod.min, il->data.tod.sec, il->data.tod.msec);
+            break;
+        case LIT_DATE:
+            fprintf(out, "        [year: %d, month: %d, day: %d]\n", il->data.date.year, il->data.date.month, il->data.date.day);
+            break;
+        case LIT_DATE_AND_TIME:
+            fprintf(out, "        [year: %d, month: %d, day: %d, H: %d, M: %d, S: %d, MS: %d]\n",
+                    il->data.dt.date.year,
+                    il->data.dt.date.month,
+                    il->data.dt.date.day,
+                    il->data.dt.tod.hour,
+                    il->data.dt.tod.min,
+                    il->data.dt.tod.sec,
+                    il->data.dt.tod.msec
+                    );
+            break;
+        case LIT_INTEGER:
+        case LIT_BASE2:
+        case LIT_BASE8:
+        case LIT_BASE16:
+            fprintf(out, "        [integer: %" PRId64 "]\n", il->data.integer);
+            break;
+        case LIT_REAL:
+        case LIT_REAL_EXP:
+            fprintf(out, "        [real: %f]\n", il->data.real);
+            break;
+        case LIT_PHY:
+            fprintf(out, "        [prefix: %d[%c], datatype: %d[%c] ",
+                    il->data.phy.prefix,
+                    phy_prefix_c[il->data.phy.prefix],
+                    il->data.phy.datatype,
+                    phy_data_type_c[il->data.phy.datatype]
+                    );
+            switch (il->data.phy.datatype) {
+                case PHY_D_BIT:
+                    fprintf(out, "phy_a: %d, phy_b: %d]\n", il->data.phy.data.bit.phy_a, il->data.phy.data.bit.phy_b);
+                    break;
+                case PHY_D_BYTE:
+                    fprintf(out, "phy_byte: %d]\n", il->data.phy.data.byte);
+                    break;
+                case PHY_D_WORD:
+                    fprintf(out, "phy_word: %d]\n", il->data.phy.data.word);
+                    break;
+                case PHY_D_DOUBLE:
+                    fprintf(out, "phy_double: %f]\n", il->data.phy.data.dbl);
+            }
+            break;
+        case LIT_STRING:
+            fprintf(out, "        [string: %s]\n", il->data.str->data);
+            break;
+        case LIT_VAR:
+            fprintf(out, "        [variable: %s]\n", il->data.str->data);
+            break;
+        case LIT_VAD:
+            for (uint32_t n = 0; n < il->data.vad.len; n++)
+                fprintf(out, "        [%s : %s] [datatype: %s, size: %u, align: %u]\n",
+                        il->data.vad.var[n].name->data,
+                        il->data.vad.var[n].type->data,
+                        pfx_iectype[il->data.vad.var[n].datatype],
+                        il->data.vad.var[n].size,
+                        il->data.vad.var[n].align
+                        );
+            fprintf(out, "          [section: %s]\n", var_section_str[il->data.vad.section]);
+            break;
+        case LIT_CAL:
+            fprintf(out, "    [func: %s]\n", il->data.cal.func->data);
+            for (uint32_t n = 0; n < il->data.cal.len; n++) {
+                fprintf(out, "    [ %s [in/out: %d] lit_dataformat: %s, iec_datatype: %s ]\n",
+                        il->data.cal.arg[n].var->data,
+                        il->data.cal.arg[n].in_out,
+                        lit_dataformat_str[il->data.cal.arg[n].value.lit_dataformat],
+                        pfx_iectype[il->data.cal.arg[n].value.iec_datatype]
+                        );
+                console_value(out, &(il->data.cal.arg[n].value));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// CAL arguments are shown with the call
+static void console_literal(void *ctx, const il_t *il, uint32_t arg) {
+    if (arg == IL_NO_ARG)
+        console_value(CONSOLE_OUT(ctx), il);
+}
+
+static void console_jump(void *ctx, uint32_t index, uint32_t jmp_addr) {
+    FILE *out = CONSOLE_OUT(ctx);
+
+    fprintf(out, "    [JUMP: %04d -> %04d]\n", index, jmp_addr);
+}
+
+static void console_diag(void *ctx, const il_diag_t *diag) {
+    FILE *out = CONSOLE_OUT(ctx);
+
+    fprintf(out, "    [ERROR: %s (line: %d, column: %d)]\n", diag->message->data, diag->line, diag->column);
+}
+
+static void console_parsed(void *ctx, uint32_t index, const il_t *il) {
+    FILE *out = CONSOLE_OUT(ctx);
+
+    (void) index;
+    (void) il;
+
+    fprintf(out, "\n");
 }
+
+const il_listener_t il_console_listener = {
+        .ctx = NULL,
+        .source = console_source,
+        .expansion = console_expansion,
+        .label = console_label,
+        .instruction = console_instruction,
+        .literal = console_literal,
+        .jump = console_jump,
+        .diag = console_diag,
+        .parsed = console_parsed
+};
+
+///////////////////////////////////////////////////////////////
@@ -33,18 +33,12 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
+#include "il_arena.h"
+#include "il_alloc.h"
 #include "strings.h"
 
-#define DEBUG
-
-#ifdef DEBUG
-    #define DBG_PRINT(fmt, args...)  \
-                printf(fmt, ##args)
-#else
-    #define DBG_PRINT(fmt, args...)
-#endif
-
 typedef enum COMMANDS {
 //   instr  //       | modifiers |  description
     IL_NOP, //  0x00 |           |  Not operation
@@ -74,7 +68,7 @@ typedef enum COMMANDS {
     IL_18,  //  0x18 |           |  not defined.
     IL_19,  //  0x19 |           |  not defined.
     IL_1A,  //  0x1a |           |  not defined.
-    IL_1B,  //  0x1b |           |  not defined.
+    IL_VAI, //  0x1b |           |  Variables definition (internal use).
     IL_VAO, //  0x1c |           |  Variables definition (internal use).
     IL_VAD, //  0x1d |           |  Variables definition (internal use).
     IL_CAI, //  0x1e |           |  Call implicit (function) (internal use)
@@ -152,7 +146,27 @@ typedef enum PHY_DATATYPE {
     PHY_D_DOUBLE, //
 } il_phy_datatype_t;
 
+typedef enum VAR_SECTION {
+    IL_VAR_LOCAL,  // VAR
+    IL_VAR_INPUT,  // VAR_INPUT
+    IL_VAR_OUTPUT, // VAR_OUTPUT
+} il_var_section_t;
+
+// size and align are the natural storage of declared type (TIME, DATE, TOD: 4/4, DT: 8/8), not the parser representation
+// of literals. 0 is defined by runtime: STRING, WSTRING and function block instances (IEC_T_TIMER, IEC_T_USER)
+typedef struct il_var_decl_s {
+           String name;     // variable name
+           String type;     // type name as written
+         uint32_t name_id;  // symbol id of name (IL_NO_SYMBOL without symbols table)
+         uint32_t type_id;  // symbol id of type (IL_NO_SYMBOL without symbols table)
+    il_datatype_t datatype; // IEC_T_USER: function block or user type
+         uint32_t size;     // storage size in bytes (0: defined by runtime)
+         uint32_t align;    // storage alignment in bytes (0: defined by runtime)
+} il_var_decl_t;
+
 typedef struct il il_t;
+typedef struct il_cal_arg_s il_cal_arg_t;
+
 struct il {
       il_commands_t code;               // IL code
                bool c;                  // conditional
@@ -204,29 +218,115 @@ struct il {
             } tod;                      //
         } dt;                           //
         struct {
-                bool not_formal;        //
-            uint32_t len;               //
-              String func;              //
-              String *var;              //
-                il_t *value;            //
-                bool *in_out;           // false: input parameter, true: output parameter
+                    bool not_formal;    //
+                uint32_t len;           //
+                  String func;          //
+            il_cal_arg_t *arg;          // arguments (contiguous)
         } cal;                          //
         struct {
-            uint32_t len;               //
-                bool output;            //
-              String *var;              //
-              String *value;            //
+                    uint32_t len;       //
+            il_var_section_t section;   //
+               il_var_decl_t *var;      // declarations (contiguous)
         } vad;                          //
     } data;                             //
 };
 
+struct il_cal_arg_s {
+    String var;    // parameter name (NOT_FORMAL if call is not formal)
+      bool in_out; // false: input parameter, true: output parameter
+      il_t value;  //
+};
+
+typedef enum STATUS {
+    IL_OK,      // no errors
+    IL_E_OPEN,  // source can't be opened (see diagnostics)
+    IL_E_PARSE, // source has errors (see diagnostics)
+} il_status_t;
+
+typedef struct il_diag_s {
+    uint32_t line;    // source line (start in 1, 0 if not related to a line)
+    uint32_t column;  // source column (start in 1)
+      String message; //
+} il_diag_t;
+
+#define IL_NO_SYMBOL UINT32_MAX // symbol not found
+
+typedef struct il_symbols_s {
+        String *name;  // names by symbol id (dense, in order of first use)
+      uint32_t *hash;  // hash of each name
+      uint32_t *index; // hash table (symbol id + 1, 0 is empty)
+      uint32_t qty;    //
+      uint32_t cap;    // hash table size (power of 2)
+    il_arena_t *arena; // names memory (NULL: heap)
+} il_symbols_t;
+
 typedef struct {
-         int lines;   //
-        il_t **result; //
+           int lines;    //
+           il_t *code;   // instructions (contiguous)
+          il_t **result; // pointers to each one of code
+     il_diag_t *diag;    // diagnostics in source order
+      uint32_t diag_qty; //
+  il_symbols_t symbols;  // identifiers (shared by all instructions)
+    il_arena_t arena;    // memory of operands
+il_mem_stats_t mem;      // memory used by parse (current: in use by result)
 } parsed_il_t;
 
-void parse_file_il(char *file, parsed_il_t *parsed);
-void free_il(il_t **il);
+typedef enum EXPANSION {
+    IL_EXP_START, // first line of instruction
+    IL_EXP_LINE,  // continuation line
+    IL_EXP_END    // end of instruction (also when unfinished, see diagnostics)
+} il_expansion_state_t;
+
+typedef struct il_expansion_s {
+    il_expansion_state_t state;  //
+         il_dataformat_t format; // LIT_CAL or LIT_VAD
+              const char *opcode; // opcode (upper case)
+              const char *text;  // normalized text of source line (IL_EXP_START: operand part, not null-terminated)
+                uint32_t len;    //
+                uint32_t line;   // source line
+} il_expansion_t;
+
+#define IL_NO_ARG UINT32_MAX // literal event of instruction value
+
+/*
+ * Parser events. Any callback can be NULL, a NULL listener disables all of them.
+ * Pointers passed are valid only during the call.
+ */
+typedef struct il_listener_s {
+    void *ctx;                                                                                               // first argument of callbacks
+    void (*source)(void *ctx, const char *file);                                                             // file opened
+    void (*expansion)(void *ctx, const il_expansion_t *expansion);                                           // instruction in several lines
+    void (*label)(void *ctx, const char *name, uint32_t len, uint32_t index);                                // label of instruction index
+    void (*instruction)(void *ctx, uint32_t index, const char *opcode, const char *operand, const il_t *il); // instruction recognized (value not decoded yet)
+    void (*literal)(void *ctx, const il_t *il, uint32_t arg);                                                // value decoded (arg: IL_NO_ARG or CAL argument)
+    void (*jump)(void *ctx, uint32_t index, uint32_t jmp_addr);                                              // jump address resolved
+    void (*diag)(void *ctx, const il_diag_t *diag);                                                          // error found
+    void (*parsed)(void *ctx, uint32_t index, const il_t *il);                                               // instruction complete (IL_NOP if it has errors)
+} il_listener_t;
+
+extern const il_listener_t il_console_listener; // dump to stdout (ctx of a copy: FILE* to dump to)
+
+typedef struct il_parser_s il_parser_t; // instruction iterator
+
+    il_parser_t* il_parser_open(char *file, const il_listener_t *listener);
+    il_parser_t* il_parser_open_buffer(const char *src, size_t len, const il_listener_t *listener);
+            void il_parser_arena(il_parser_t *parser, il_arena_t *arena);
+            void il_parser_symbols(il_parser_t *parser, il_symbols_t *symbols);
+            bool il_parser_next(il_parser_t *parser, il_t **instruction);
+            bool il_parser_fixup(il_parser_t *parser, uint32_t *line, uint32_t *jmp_addr);
+const il_diag_t* il_parser_diag(il_parser_t *parser, uint32_t *qty);
+const il_mem_stats_t* il_parser_mem(const il_parser_t *parser);
+            void il_parser_close(il_parser_t *parser);
+
+            void il_symbols_init(il_symbols_t *symbols, il_arena_t *arena);
+        uint32_t il_symbols_intern(il_symbols_t *symbols, const char *name, uint32_t len);
+        uint32_t il_symbols_find(const il_symbols_t *symbols, const char *name, uint32_t len);
+            void il_symbols_free(il_symbols_t *symbols);
+
+     il_status_t parse_file_il(char *file, parsed_il_t *parsed, const il_listener_t *listener);
+     il_status_t parse_buffer_il(const char *src, size_t len, parsed_il_t *parsed, const il_listener_t *listener);
+            void free_il(il_t **il);
+            void free_parsed_il(parsed_il_t *parsed);
 
 #endif /* IL_PARSER_H_ */
 
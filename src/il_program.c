@@ -0,0 +1,263 @@
+/**
+ * @file il_program.c
+ * @brief compact program: 16 bytes instructions and side tables
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "il_program.h"
+#include "il_alloc.h"
+
+static uint32_t pack_str(il_program_t *program, const String str) {
+    uint32_t offset = program->strings_len;
+
+    memcpy(program->strings + offset, str->data, str->length + 1);
+    program->strings_len += str->length + 1;
+
+    return offset;
+}
+
+static uint32_t pack_sym(il_program_t *program, const String name) {
+    return il_symbols_intern(&(program->symbols), name->data, name->length);
+}
+
+static void pack_value(il_program_t *program, const il_t *il, il_ins_t *ins) {
+    ins->format = il->lit_dataformat;
+    ins->datatype = il->iec_datatype;
+    ins->aux = 0;
+    ins->imm.integer = 0;
+
+    switch (il->lit_dataformat) {
+        case LIT_BOOLEAN:
+            ins->imm.integer = il->data.boolean;
+            break;
+        case LIT_DURATION:
+        case LIT_TIME_OF_DAY:
+            ins->imm.tod.msec = il->data.tod.msec;
+            ins->imm.tod.sec = il->data.tod.sec;
+            ins->imm.tod.min = il->data.tod.min;
+            ins->imm.tod.hour = il->data.tod.hour;
+            break;
+        case LIT_DATE:
+            ins->imm.date.day = il->data.date.day;
+            ins->imm.date.month = il->data.date.month;
+            ins->imm.date.year = il->data.date.year;
+            break;
+        case LIT_DATE_AND_TIME:
+            ins->imm.dt.date.day = il->data.dt.date.day;
+            ins->imm.dt.date.month = il->data.dt.date.month;
+            ins->imm.dt.date.year = il->data.dt.date.year;
+            ins->imm.dt.tod.msec = il->data.dt.tod.msec;
+            ins->imm.dt.tod.sec = il->data.dt.tod.sec;
+            ins->imm.dt.tod.min = il->data.dt.tod.min;
+            ins->imm.dt.tod.hour = il->data.dt.tod.hour;
+            break;
+        case LIT_INTEGER:
+        case LIT_BASE2:
+        case LIT_BASE8:
+        case LIT_BASE16:
+            ins->imm.integer = il->data.integer;
+            break;
+        case LIT_REAL:
+        case LIT_REAL_EXP:
+            ins->imm.real = il->data.real;
+            break;
+        case LIT_PHY:
+            ins->aux = il->data.phy.prefix | il->data.phy.datatype << 8;
+            switch (il->data.phy.datatype) {
+                case PHY_D_BIT:
+                    ins->imm.phy.bit.phy_a = il->data.phy.data.bit.phy_a;
+                    ins->imm.phy.bit.phy_b = il->data.phy.data.bit.phy_b;
+                    break;
+                case PHY_D_BYTE:
+                    ins->imm.phy.byte = il->data.phy.data.byte;
+                    break;
+                case PHY_D_WORD:
+                    ins->imm.phy.word = il->data.phy.data.word;
+                    break;
+                case PHY_D_DOUBLE:
+                    ins->imm.phy.dbl = il->data.phy.data.dbl;
+                    break;
+            }
+            break;
+        case LIT_STRING:
+            ins->imm.str = pack_str(program, il->data.str);
+            break;
+        case LIT_VAR:
+            ins->imm.sym = pack_sym(program, il->data.str);
+            break;
+        case LIT_CAL:
+            ins->flags |= il->data.cal.not_formal ? IL_F_NOT_FORMAL : 0;
+            ins->aux = il->data.cal.len;
+            ins->imm.cal.func = pack_sym(program, il->data.cal.func);
+            ins->imm.cal.arg = program->args_qty;
+            for (uint32_t n = 0; n < il->data.cal.len; n++) {
+                il_arg_t *arg = &(program->args[program->args_qty++]);
+
+                arg->var = pack_sym(program, il->data.cal.arg[n].var);
+                arg->in_out = il->data.cal.arg[n].in_out;
+                arg->value.code = IL_NOP;
+                arg->value.flags = 0;
+                pack_value(program, &(il->data.cal.arg[n].value), &(arg->value));
+            }
+            break;
+        case LIT_VAD:
+            if (il->data.vad.section == IL_VAR_OUTPUT)
+                ins->format = LIT_VAO;
+            ins->aux = il->data.vad.len;
+            ins->imm.decl = program->decls_qty;
+            for (uint32_t n = 0; n < il->data.vad.len; n++) {
+                il_decl_t *decl = &(program->decls[program->decls_qty++]);
+
+                decl->var = pack_sym(program, il->data.vad.var[n].name);
+                decl->type = pack_sym(program, il->data.vad.var[n].type);
+                decl->size = il->data.vad.var[n].size;
+                decl->datatype = il->data.vad.var[n].datatype;
+                decl->section = il->data.vad.section;
+                decl->align = il->data.vad.var[n].align;
+            }
+            break;
+        default:
+            break;
+    }
+
+    // jump address is not a literal
+    if (ins->code == IL_JMP)
+        ins->imm.jmp_addr = il->data.jmp_addr;
+}
+
+// side tables sizes
+static void count_value(const il_t *il, uint32_t *args, uint32_t *decls, uint32_t *strings) {
+    switch (il->lit_dataformat) {
+        case LIT_STRING:
+            *strings += il->data.str->length + 1;
+            break;
+        case LIT_CAL:
+            *args += il->data.cal.len;
+            for (uint32_t n = 0; n < il->data.cal.len; n++)
+                count_value(&(il->data.cal.arg[n].value), args, decls, strings);
+            break;
+        case LIT_VAD:
+            *decls += il->data.vad.len;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @fn void il_program_pack(const parsed_il_t *parsed, il_program_t *program)
+ * @brief Pack parsed instructions in 16 bytes records. Parse result is not modified and can be freed after this
+ *
+ * @param parsed Parse result
+ * @param program Packed program (free with il_program_free)
+ */
+void il_program_pack(const parsed_il_t *parsed, il_program_t *program) {
+    uint32_t len = (uint32_t) parsed->lines, args = 0, decls = 0, strings = 0;
+
+    for (uint32_t n = 0; n < len; n++)
+        count_value(&(parsed->code[n]), &args, &decls, &strings);
+
+    program->len = len;
+    program->code = il_malloc(program->len * sizeof(il_ins_t));
+    program->args = il_malloc(args * sizeof(il_arg_t));
+    program->decls = il_malloc(decls * sizeof(il_decl_t));
+    program->strings = il_malloc(strings);
+    program->args_qty = program->decls_qty = program->strings_len = 0;
+    il_symbols_init(&(program->symbols), NULL);
+
+    for (uint32_t n = 0; n < program->len; n++) {
+        const il_t *il = &(parsed->code[n]);
+        il_ins_t *ins = &(program->code[n]);
+
+        ins->code = il->code;
+        ins->flags = (il->c ? IL_F_C : 0) | (il->n ? IL_F_N : 0) | (il->p ? IL_F_P : 0);
+        pack_value(program, il, ins);
+    }
+}
+
+/**
+ * @fn const char* il_program_str(const il_program_t *program, uint32_t offset)
+ * @brief String of side table
+ *
+ * @param program Program
+ * @param offset Offset in strings (imm.str)
+ * @return Null-terminated string
+ */
+const char* il_program_str(const il_program_t *program, uint32_t offset) {
+    return program->strings + offset;
+}
+
+/**
+ * @fn const char* il_program_symbol(const il_program_t *program, uint32_t id)
+ * @brief Name of symbol
+ *
+ * @param program Program
+ * @param id Symbol id (imm.sym, imm.cal.func, il_arg_t.var, il_decl_t.var/type)
+ * @return Null-terminated name
+ */
+const char* il_program_symbol(const il_program_t *program, uint32_t id) {
+    return program->symbols.name[id]->data;
+}
+
+/**
+ * @fn size_t il_program_size(const il_program_t *program)
+ * @brief Memory used by program (instructions and side tables)
+ *
+ * @param program Program
+ * @return Size in bytes
+ */
+size_t il_program_size(const il_program_t *program) {
+    size_t size = program->len * sizeof(il_ins_t) + program->args_qty * sizeof(il_arg_t) + program->decls_qty * sizeof(il_decl_t) + program->strings_len;
+
+    for (uint32_t n = 0; n < program->symbols.qty; n++)
+        size += sizeof(string_t) + program->symbols.name[n]->length + 1;
+
+    return size + program->symbols.qty * (sizeof(String) + sizeof(uint32_t)) + program->symbols.cap * sizeof(uint32_t);
+}
+
+/**
+ * @fn void il_program_free(il_program_t *program)
+ * @brief Free program
+ *
+ * @param program Program
+ */
+void il_program_free(il_program_t *program) {
+    il_free(program->code);
+    il_free(program->args);
+    il_free(program->decls);
+    il_free(program->strings);
+    il_symbols_free(&(program->symbols));
+
+    program->code = NULL;
+    program->args = NULL;
+    program->decls = NULL;
+    program->strings = NULL;
+    program->len = program->args_qty = program->decls_qty = program->strings_len = 0;
+}
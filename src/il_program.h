@@ -0,0 +1,132 @@
+/**
+ * @file il_program.h
+ * @brief compact program: 16 bytes instructions and side tables
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef IL_PROGRAM_H_
+#define IL_PROGRAM_H_
+
+#include <stdint.h>
+
+#include "il_parser.h"
+
+#define IL_F_C          0x01 // conditional
+#define IL_F_N          0x02 // negate
+#define IL_F_P          0x04 // push '('
+#define IL_F_NOT_FORMAL 0x08 // LIT_CAL: not formal arguments
+
+typedef struct il_tod_s {
+    uint8_t msec; //
+    uint8_t sec;  //
+    uint8_t min;  //
+    uint8_t hour; //
+} il_tod_t;
+
+typedef struct il_date_s {
+     uint8_t day;   //
+     uint8_t month; //
+    uint16_t year;  //
+} il_date_t;
+
+/*
+ * Packed instruction. Values up to 8 bytes are immediate, the rest are indexes of program side tables:
+ *   LIT_STRING          : imm.str
+ *   LIT_VAR             : imm.sym
+ *   LIT_CAL             : imm.cal, aux = number of arguments
+ *   LIT_VAD, LIT_VAO    : imm.decl (first declaration), aux = number of declarations (LIT_VAO: output variables, section in each declaration)
+ *   LIT_PHY             : imm.phy, aux = il_phy_prefix_t | il_phy_datatype_t << 8
+ */
+typedef struct il_ins_s {
+     uint8_t code;     // il_commands_t
+     uint8_t flags;    // IL_F_*
+     uint8_t format;   // il_dataformat_t
+     uint8_t datatype; // il_datatype_t
+    uint32_t aux;      //
+    union {
+          int64_t integer;      // LIT_BOOLEAN, LIT_INTEGER, LIT_BASE*
+           double real;         // LIT_REAL, LIT_REAL_EXP
+         uint32_t jmp_addr;     // IL_JMP
+         uint32_t str;          // offset in strings
+         uint32_t sym;          // symbol id
+         uint32_t decl;         // index in decls
+         il_tod_t tod;          // LIT_DURATION, LIT_TIME_OF_DAY
+        il_date_t date;         // LIT_DATE
+        struct {
+            il_date_t date;     //
+             il_tod_t tod;      //
+        } dt;                   // LIT_DATE_AND_TIME
+        struct {
+            uint32_t func;      // symbol id
+            uint32_t arg;       // index in args
+        } cal;                  //
+        union {
+            struct {
+                uint32_t phy_a; //
+                uint32_t phy_b; //
+            } bit;              //
+             uint8_t byte;      //
+            uint16_t word;      //
+              double dbl;       //
+        } phy;                  //
+    } imm;                      //
+} il_ins_t;
+
+typedef struct il_arg_s {
+    uint32_t var;    // symbol id
+        bool in_out; // false: input parameter, true: output parameter
+    il_ins_t value;  // code is IL_NOP
+} il_arg_t;
+
+typedef struct il_decl_s {
+    uint32_t var;      // symbol id
+    uint32_t type;     // symbol id
+    uint32_t size;     // storage size in bytes (0: defined by runtime)
+     uint8_t datatype; // il_datatype_t
+     uint8_t section;  // il_var_section_t
+     uint8_t align;    // storage alignment in bytes (0: defined by runtime)
+} il_decl_t;
+
+typedef struct il_program_s {
+     il_ins_t *code;        // instructions
+     uint32_t len;          //
+     il_arg_t *args;        // CAL arguments
+     uint32_t args_qty;     //
+    il_decl_t *decls;       // VAR declarations
+     uint32_t decls_qty;    //
+         char *strings;     // null-terminated strings of LIT_STRING
+     uint32_t strings_len;  //
+ il_symbols_t symbols;      // identifiers
+} il_program_t;
+
+       void il_program_pack(const parsed_il_t *parsed, il_program_t *program);
+const char* il_program_str(const il_program_t *program, uint32_t offset);
+const char* il_program_symbol(const il_program_t *program, uint32_t id);
+     size_t il_program_size(const il_program_t *program);
+       void il_program_free(il_program_t *program);
+
+#endif /* IL_PROGRAM_H_ */
@@ -37,11 +37,138 @@
 #include <stdio.h>
 #include <float.h>
 #include <limits.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "strings.h"
 #include "siphash.h"
 #include "halfsiphash.h"
 
+///// allocator /////
+
+static void* mem_alloc(void *ctx, size_t size) {
+    (void) ctx;
+
+    return malloc(size);
+}
+
+static void* mem_realloc(void *ctx, void *ptr, size_t old_size, size_t size) {
+    (void) ctx;
+    (void) old_size;
+
+    return realloc(ptr, size);
+}
+
+static void mem_free(void *ctx, void *ptr, size_t size) {
+    (void) ctx;
+    (void) size;
+
+    free(ptr);
+}
+
+static string_allocator_t allocator = { mem_alloc, mem_realloc, mem_free, NULL };
+
+/**
+ * @fn void string_set_allocator(const string_allocator_t *hooks)
+ * @brief Set memory functions of buffered strings. Must be called before any string is allocated.
+ *        With the default ones (libc) strings can also be released with free()
+ *
+ * @param hooks Memory functions (NULL: libc)
+ */
+void string_set_allocator(const string_allocator_t *hooks) {
+    if (hooks == NULL)
+        allocator = (string_allocator_t){ mem_alloc, mem_realloc, mem_free, NULL };
+    else
+        allocator = *hooks;
+}
+
+/**
+ * @fn const string_allocator_t* string_get_allocator(void)
+ * @brief Current memory functions of buffered strings
+ *
+ * @return Memory functions
+ */
+const string_allocator_t* string_get_allocator(void) {
+    return &allocator;
+}
+
+////////////////
+
+///// case folding /////
+
+#define TO_LOWER(c) (((c) >= 'A' && (c) <= 'Z') ? (c) + 32 : (c))
+
+#if defined(__AVX2__)
+// letters of range [lo, hi] (both lower or upper case) with 0x20 toggled
+static inline __m256i fold_range32(__m256i v, char lo, char hi) {
+    __m256i in = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(lo - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), v));
+    return _mm256_xor_si256(v, _mm256_and_si256(in, _mm256_set1_epi8(0x20)));
+}
+
+static inline __m256i fold_lower32(__m256i v) {
+    return fold_range32(v, 'A', 'Z');
+}
+#elif defined(__SSE2__)
+// letters of range [lo, hi] (both lower or upper case) with 0x20 toggled
+static inline __m128i fold_range16(__m128i v, char lo, char hi) {
+    __m128i in = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmpgt_epi8(_mm_set1_epi8(hi + 1), v));
+    return _mm_xor_si128(v, _mm_and_si128(in, _mm_set1_epi8(0x20)));
+}
+
+static inline __m128i fold_lower16(__m128i v) {
+    return fold_range16(v, 'A', 'Z');
+}
+#endif
+
+// signed compares: bytes over 0x7f are negative and never in range
+static void mem_fold(char *dst, const char *src, uint32_t len, char lo, char hi) {
+    uint32_t n = 0;
+
+#if defined(__AVX2__)
+    for (; len - n >= 32; n += 32)
+        _mm256_storeu_si256((__m256i*) (dst + n), fold_range32(_mm256_loadu_si256((const __m256i*) (src + n)), lo, hi));
+#elif defined(__SSE2__)
+    for (; len - n >= 16; n += 16)
+        _mm_storeu_si128((__m128i*) (dst + n), fold_range16(_mm_loadu_si128((const __m128i*) (src + n)), lo, hi));
+#endif
+
+    for (; n < len; n++)
+        dst[n] = (src[n] >= lo && src[n] <= hi) ? src[n] ^ 0x20 : src[n];
+}
+
+////////////////
+
+///// white space /////
+
+// isspace() of "C" locale without locale lookup: ' ', '\t', '\n', '\v', '\f', '\r'
+#define IS_SPACE(c) ((c) == ' ' || ((c) >= '\t' && (c) <= '\r'))
+
+#if defined(__SSE2__)
+// bit set for each byte that is not white space
+static inline uint32_t nonspace_mask16(const char *p) {
+    __m128i v = _mm_loadu_si128((const __m128i*) p);
+    __m128i sp = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+            _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('\t' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('\r' + 1), v)));
+
+    return ~_mm_movemask_epi8(sp) & 0xffff;
+}
+#endif
+
+#if defined(__AVX2__)
+static inline uint32_t nonspace_mask32(const char *p) {
+    __m256i v = _mm256_loadu_si256((const __m256i*) p);
+    __m256i sp = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+            _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('\t' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), v)));
+
+    return ~(uint32_t) _mm256_movemask_epi8(sp);
+}
+#endif
+
+////////////////
+
 ///// core /////
 
 /**
@@ -58,6 +185,20 @@
  */
 #define BUF_MEM(cap)  (sizeof(string_t) + (cap + 1) * BUF_CHR)
 
+/**
+ * @def BUF_CAP
+ * @brief capacity of buffered string (without STRING_INLINE flag)
+ *
+ */
+#define BUF_CAP(buf)  ((buf)->capacity & ~STRING_INLINE)
+
+/**
+ * @def BUF_INLINE
+ * @brief buffered string storage is not owned by allocator
+ *
+ */
+#define BUF_INLINE(buf) (((buf)->capacity & STRING_INLINE) != 0)
+
 /**
  * @fn String string_buf_new(const size_t cap)
  * @brief Allocate a new Buffer of capacity `cap`.
@@ -66,9 +207,13 @@
  * @return  Buffered string
  */
 String string_new(const size_t cap) {
-    String buf = calloc(1, BUF_MEM(cap));
+    if (cap >= STRING_INLINE)
+        return NULL;
+
+    String buf = allocator.alloc(allocator.ctx, BUF_MEM(cap));
 
     if (buf) {
+        memset(buf, 0, BUF_MEM(cap));
         buf->capacity = cap;
         buf->length = 0;
         buf->data[0] = 0;
@@ -107,11 +252,12 @@ String string_dup(const String buf) {
     if (buf == NULL)
         return NULL;
 
-    String ret = string_new(buf->capacity);
+    String ret = string_new(BUF_CAP(buf));
 
     if (ret) {
         // copies only up to current length
         memcpy(ret, buf, BUF_MEM(buf->length));
+        ret->capacity = BUF_CAP(buf);
     }
 
     return ret;
@@ -129,109 +275,745 @@ bool string_resize(String *pbuf, const size_t newcap) {
     if (pbuf == NULL || *pbuf == NULL)
         return false;
 
-    String buf = *pbuf;
-
-    if (newcap == buf->capacity)
-        return true;
+    String buf = *pbuf;
+
+    if (newcap == BUF_CAP(buf))
+        return true;
+
+    if (newcap >= STRING_INLINE)
+        return false;
+
+    uint32_t buflen = buf->length;
+    String tmp;
+
+    if (BUF_INLINE(buf)) {
+        // inline storage is not owned: truncate in place or move to heap
+        if (newcap < BUF_CAP(buf)) {
+            if (newcap < buflen) {
+                buf->data[newcap] = 0;
+                buf->length = newcap;
+            }
+            return true;
+        }
+
+        if ((tmp = string_new(newcap)) == NULL)
+            return false;
+
+        memcpy(tmp->data, buf->data, buflen + 1);
+        tmp->length = buflen;
+        *pbuf = tmp;
+
+        return true;
+    }
+
+    tmp = allocator.realloc(allocator.ctx, buf, BUF_MEM(buf->capacity), BUF_MEM(newcap));
+
+    if (!tmp)
+        return false;
+
+    // truncated
+    if (newcap < buflen) {
+        tmp->data[newcap] = 0;
+        tmp->length = newcap;
+    }
+
+    tmp->capacity = newcap;
+    *pbuf = tmp;
+
+    return true;
+}
+
+/**
+ * @fn void string_move(String *to, String *from)
+ * @brief Copy string and free from
+ *
+ * @param to Buffered string
+ * @param from Buffered string
+ */
+uint32_t string_move(String *to, String *from) {
+    if (to == NULL || from == NULL || *to == NULL || *from == NULL)
+        return UINT32_MAX;
+
+    if ((*from)->length > (*to)->length)
+        if (!string_resize(to, BUF_CAP(*from)))
+            return UINT32_MAX;
+
+    uint32_t cap = (*to)->capacity;
+
+    memcpy((*to), (*from), BUF_MEM((*from)->length));
+    (*to)->capacity = cap;
+    (*to)->length = (*from)->length;
+    string_free(*from);
+
+    return 0;
+}
+
+/**
+ * @fn void string_free(String buf)
+ * @brief Free buffered string
+ *
+ * @param buf Buffered string (NULL or inline: nothing)
+ */
+void string_free(String buf) {
+    if (buf != NULL && !BUF_INLINE(buf))
+        allocator.free(allocator.ctx, buf, BUF_MEM(buf->capacity));
+}
+
+/**
+ * @fn uint32_t string_copy(String *to, const char *from)
+ * @brief Copy string
+ *
+ * @param to Buffered string
+ * @param from string
+ */
+uint32_t string_copy(String *to, const char *from) {
+    if (to == NULL || *to == NULL || from == NULL)
+        return UINT32_MAX;
+
+    size_t lenf = strlen(from);
+    if (lenf > UINT32_MAX - 1)
+        return UINT32_MAX;
+
+    if (lenf > (*to)->length)
+        if (!string_resize(to, BUF_MEM(lenf)))
+            return UINT32_MAX;
+
+    memcpy((*to)->data, from, lenf + 1);
+    (*to)->length = lenf;
+
+    return 0;
+}
+
+/**
+ * @fn const char* string_buf_data(const String buf)
+ * @brief Return Data of Buffered string
+ *
+ * @param buf Buffered string
+ * @return String
+ */
+const char* string_data(const String buf) {
+    if (buf == NULL)
+        return NULL;
+
+    return buf->data;
+}
+
+/**
+ * @fn void string_buf_reset(String buf)
+ * @brief Reset Buffered string content
+ *
+ * @param buf Buffered string
+ */
+void string_reset(String buf) {
+    if (buf == NULL)
+        return;
+
+    buf->length = 0;
+    buf->data[0] = 0;
+}
+
+///// in place /////
+
+/**
+ * @fn bool string_grow(String *pbuf, uint32_t len)
+ * @brief Ensure capacity for length (at least doubled when grows)
+ *
+ * @param pbuf Buffered string
+ * @param len Length
+ * @return Boolean
+ */
+static bool string_grow(String *pbuf, uint32_t len) {
+    uint32_t cap = BUF_CAP(*pbuf);
+
+    if (len <= cap)
+        return true;
+
+    return string_resize(pbuf, len > cap * 2 ? len : (cap * 2 < STRING_INLINE ? cap * 2 : STRING_INLINE - 1));
+}
+
+/**
+ * @fn bool string_left_self(String *pbuf, uint32_t pos)
+ * @brief Substring left from position (in place)
+ *
+ * @param pbuf Buffered string
+ * @param pos Position
+ * @return Boolean
+ */
+bool string_left_self(String *pbuf, uint32_t pos) {
+    if (pbuf == NULL || *pbuf == NULL || pos > (*pbuf)->length)
+        return false;
+
+    if (pos < (*pbuf)->length) {
+        (*pbuf)->length = pos + 1;
+        (*pbuf)->data[pos + 1] = '\0';
+    }
+
+    return true;
+}
+
+/**
+ * @fn bool string_right_self(String *pbuf, uint32_t pos)
+ * @brief Substring right from position (in place)
+ *
+ * @param pbuf Buffered string
+ * @param pos Position
+ * @return Boolean
+ */
+bool string_right_self(String *pbuf, uint32_t pos) {
+    if (pbuf == NULL || *pbuf == NULL || pos > (*pbuf)->length)
+        return false;
+
+    memmove((*pbuf)->data, (*pbuf)->data + pos, (*pbuf)->length - pos + 1);
+    (*pbuf)->length -= pos;
+
+    return true;
+}
+
+/**
+ * @fn bool string_mid_self(String *pbuf, uint32_t left, uint32_t right)
+ * @brief Substring left from position left to position right (in place)
+ *
+ * @param pbuf Buffered string
+ * @param left Position (start in 1)
+ * @param right Position
+ * @return Boolean
+ */
+bool string_mid_self(String *pbuf, uint32_t left, uint32_t right) {
+    if (pbuf == NULL || *pbuf == NULL || left < 1 || right > (*pbuf)->length || left > right)
+        return false;
+
+    uint32_t len = right - left + 1;
+
+    memmove((*pbuf)->data, (*pbuf)->data + left - 1, len);
+    (*pbuf)->data[len] = '\0';
+    (*pbuf)->length = len;
+
+    return true;
+}
+
+/**
+ * @fn bool string_concat_self(String *pbuf, const String str2)
+ * @brief Concatenation of strings (in place, grows if needed)
+ *
+ * @param pbuf Buffered string
+ * @param str2 Buffered string
+ * @return Boolean
+ */
+bool string_concat_self(String *pbuf, const String str2) {
+    if (pbuf == NULL || *pbuf == NULL || str2 == NULL)
+        return false;
+
+    bool self = str2 == *pbuf;
+    uint32_t len2 = str2->length;
+
+    if (!string_grow(pbuf, (*pbuf)->length + len2))
+        return false;
+
+    memcpy((*pbuf)->data + (*pbuf)->length, self ? (*pbuf)->data : str2->data, len2);
+    (*pbuf)->length += len2;
+    (*pbuf)->data[(*pbuf)->length] = '\0';
+
+    return true;
+}
+
+/**
+ * @fn bool string_insert_self(String *pbuf, const String str, uint32_t pos)
+ * @brief Insert string on position (in place, grows if needed)
+ *
+ * @param pbuf Buffered string
+ * @param str Buffered string (not pbuf)
+ * @param pos Position
+ * @return Boolean
+ */
+bool string_insert_self(String *pbuf, const String str, uint32_t pos) {
+    if (pbuf == NULL || *pbuf == NULL || str == NULL || str == *pbuf || pos > (*pbuf)->length)
+        return false;
+
+    if (!string_grow(pbuf, (*pbuf)->length + str->length))
+        return false;
+
+    memmove((*pbuf)->data + pos + str->length, (*pbuf)->data + pos, (*pbuf)->length - pos + 1);
+    memcpy((*pbuf)->data + pos, str->data, str->length);
+    (*pbuf)->length += str->length;
+
+    return true;
+}
+
+/**
+ * @fn bool string_delete_self(String *pbuf, uint32_t pos1, uint32_t pos2)
+ * @brief Delete substring from pos1 to pos2 (in place)
+ *
+ * @param pbuf Buffered string
+ * @param pos1 Position
+ * @param pos2 Position
+ * @return Boolean
+ */
+bool string_delete_self(String *pbuf, uint32_t pos1, uint32_t pos2) {
+    if (pbuf == NULL || *pbuf == NULL || pos1 > pos2 || pos2 >= (*pbuf)->length)
+        return false;
+
+    memmove((*pbuf)->data + pos1, (*pbuf)->data + pos2 + 1, (*pbuf)->length - pos2);
+    (*pbuf)->length -= pos2 - pos1 + 1;
+
+    return true;
+}
+
+/**
+ * @fn bool string_delete_c_self(String *pbuf, const char *str)
+ * @brief Delete substring str (in place)
+ *
+ * @param pbuf Buffered string
+ * @param str string
+ * @return Boolean
+ */
+bool string_delete_c_self(String *pbuf, const char *str) {
+    if (pbuf == NULL || *pbuf == NULL || str == NULL || *str == '\0')
+        return false;
+
+    uint32_t pos = string_find_c(*pbuf, str, 0);
+    if (pos == STR_ERROR)
+        return false;
+
+    return string_delete_self(pbuf, pos, pos + strlen(str) - 1);
+}
+
+/**
+ * @fn bool string_delete_prefix_self(String *pbuf, const String pfx)
+ * @brief Delete prefix (in place)
+ *
+ * @param pbuf Buffered string
+ * @param pfx Buffered string
+ * @return Boolean (false if string does not start with pfx)
+ */
+bool string_delete_prefix_self(String *pbuf, const String pfx) {
+    if (pbuf == NULL || *pbuf == NULL || pfx == NULL || pfx->length < 1 || pfx->length > (*pbuf)->length)
+        return false;
+
+    if (memcmp((*pbuf)->data, pfx->data, pfx->length))
+        return false;
+
+    return string_right_self(pbuf, pfx->length);
+}
+
+/**
+ * @fn bool string_delete_prefix_c_self(String *pbuf, const char *pfx)
+ * @brief Delete prefix const string (in place)
+ *
+ * @param pbuf Buffered string
+ * @param pfx String
+ * @return Boolean (false if string does not start with pfx)
+ */
+bool string_delete_prefix_c_self(String *pbuf, const char *pfx) {
+    if (pbuf == NULL || *pbuf == NULL || pfx == NULL)
+        return false;
+
+    size_t len = strlen(pfx);
+    if (len < 1 || len > (*pbuf)->length || memcmp((*pbuf)->data, pfx, len))
+        return false;
+
+    return string_right_self(pbuf, len);
+}
+
+/**
+ * @fn bool string_delete_postfix_self(String *pbuf, const String pfx)
+ * @brief Delete postfix (in place)
+ *
+ * @param pbuf Buffered string
+ * @param pfx Buffered string
+ * @return Boolean (false if string does not end with pfx)
+ */
+bool string_delete_postfix_self(String *pbuf, const String pfx) {
+    if (pbuf == NULL || *pbuf == NULL || pfx == NULL || pfx->length < 1 || pfx->length > (*pbuf)->length)
+        return false;
+
+    uint32_t len = (*pbuf)->length - pfx->length;
+    if (memcmp((*pbuf)->data + len, pfx->data, pfx->length))
+        return false;
+
+    (*pbuf)->data[len] = '\0';
+    (*pbuf)->length = len;
+
+    return true;
+}
+
+/**
+ * @fn bool string_delete_postfix_c_self(String *pbuf, const char *pfx)
+ * @brief Delete postfix const string (in place)
+ *
+ * @param pbuf Buffered string
+ * @param pfx String
+ * @return Boolean (false if string does not end with pfx)
+ */
+bool string_delete_postfix_c_self(String *pbuf, const char *pfx) {
+    if (pbuf == NULL || *pbuf == NULL || pfx == NULL)
+        return false;
+
+    size_t plen = strlen(pfx);
+    if (plen < 1 || plen > (*pbuf)->length)
+        return false;
+
+    uint32_t len = (*pbuf)->length - plen;
+    if (memcmp((*pbuf)->data + len, pfx, plen))
+        return false;
+
+    (*pbuf)->data[len] = '\0';
+    (*pbuf)->length = len;
+
+    return true;
+}
+
+/**
+ * @fn bool string_replace_c_self(String *pbuf, const char *c_search, const char *c_replace, uint32_t pos)
+ * @brief Replace first occurrence from position (in place, grows if needed)
+ *
+ * @param pbuf Buffered string
+ * @param c_search string
+ * @param c_replace string
+ * @param pos Start position
+ * @return Boolean (false if not found)
+ */
+bool string_replace_c_self(String *pbuf, const char *c_search, const char *c_replace, uint32_t pos) {
+    if (pbuf == NULL || *pbuf == NULL || c_search == NULL || c_replace == NULL || pos > (*pbuf)->length)
+        return false;
+
+    char *p = strstr((*pbuf)->data + pos, c_search);
+    if (p == NULL)
+        return false;
+
+    uint32_t fpos = p - (*pbuf)->data;
+    uint32_t slen = strlen(c_search), rlen = strlen(c_replace);
+
+    if (!string_grow(pbuf, (*pbuf)->length - slen + rlen))
+        return false;
+
+    memmove((*pbuf)->data + fpos + rlen, (*pbuf)->data + fpos + slen, (*pbuf)->length - fpos - slen + 1);
+    memcpy((*pbuf)->data + fpos, c_replace, rlen);
+    (*pbuf)->length = (*pbuf)->length - slen + rlen;
+
+    return true;
+}
+
+/**
+ * @fn bool string_replace_self(String *pbuf, const String search, const String replace, uint32_t pos)
+ * @brief Replace first occurrence from position (in place, grows if needed)
+ *
+ * @param pbuf Buffered string
+ * @param search Buffered string
+ * @param replace Buffered string (not pbuf)
+ * @param pos Start position
+ * @return Boolean (false if not found)
+ */
+bool string_replace_self(String *pbuf, const String search, const String replace, uint32_t pos) {
+    if (search == NULL || replace == NULL || replace == *pbuf)
+        return false;
+
+    return string_replace_c_self(pbuf, search->data, replace->data, pos);
+}
+
+/**
+ * @fn bool string_replace_all_self(String *pbuf, const char *c_search, const char *c_replace)
+ * @brief Replace all occurrences in one pass (in place, grows once if needed).
+ *        Matches are not overlapped and replaced text is not searched again, so the result differs
+ *        from repeating string_replace_c until not found when replacing creates new matches
+ *        ("    " with "  " -> " " gives "  ", the loop gives " ")
+ *
+ * @param pbuf Buffered string
+ * @param c_search String
+ * @param c_replace String (not in pbuf)
+ * @return Boolean (false if not found)
+ */
+bool string_replace_all_self(String *pbuf, const char *c_search, const char *c_replace) {
+    if (pbuf == NULL || *pbuf == NULL || c_search == NULL || c_replace == NULL || *c_search == '\0')
+        return false;
+
+    uint32_t slen = strlen(c_search), rlen = strlen(c_replace), len = (*pbuf)->length;
+    uint32_t qty = 0, shift = 0, r, w, p;
+
+    // growing: source is moved to the end of final length, writes never reach unread bytes
+    if (rlen > slen) {
+        for (r = 0; (p = string_memfind((*pbuf)->data + r, len - r, c_search, slen)) != STR_ERROR; r += p + slen)
+            ++qty;
+        if (qty == 0)
+            return false;
+
+        shift = qty * (rlen - slen);
+        if (!string_grow(pbuf, len + shift))
+            return false;
+        memmove((*pbuf)->data + shift, (*pbuf)->data, len);
+    }
+
+    char *data = (*pbuf)->data;
+    const char *src = data + shift;
+
+    for (r = w = qty = 0; (p = string_memfind(src + r, len - r, c_search, slen)) != STR_ERROR; r += p + slen, ++qty) {
+        memmove(data + w, src + r, p);
+        memcpy(data + w + p, c_replace, rlen);
+        w += p + rlen;
+    }
+    if (qty == 0)
+        return false;
+
+    memmove(data + w, src + r, len - r);
+    w += len - r;
+    data[w] = '\0';
+    (*pbuf)->length = w;
+
+    return true;
+}
+
+/**
+ * @fn bool string_delete_all_self(String *pbuf, const char *str)
+ * @brief Delete all occurrences in one pass (in place)
+ *        (as string_replace_all: "aabb" without "ab" gives "ab", not "")
+ *
+ * @param pbuf Buffered string
+ * @param str String
+ * @return Boolean (false if not found)
+ */
+bool string_delete_all_self(String *pbuf, const char *str) {
+    return string_replace_all_self(pbuf, str, "");
+}
+
+/**
+ * @fn bool string_toupper_self(String *pbuf)
+ * @brief To upper string (in place)
+ *
+ * @param pbuf Buffered string
+ * @return Boolean
+ */
+bool string_toupper_self(String *pbuf) {
+    if (pbuf == NULL || *pbuf == NULL)
+        return false;
+
+    string_memupper((*pbuf)->data, (*pbuf)->data, (*pbuf)->length);
+
+    return true;
+}
+
+/**
+ * @fn bool string_tolower_self(String *pbuf)
+ * @brief To lower string (in place)
+ *
+ * @param pbuf Buffered string
+ * @return Boolean
+ */
+bool string_tolower_self(String *pbuf) {
+    if (pbuf == NULL || *pbuf == NULL)
+        return false;
+
+    string_memlower((*pbuf)->data, (*pbuf)->data, (*pbuf)->length);
+
+    return true;
+}
+
+/**
+ * @fn bool string_ltrim_self(String *pbuf)
+ * @brief Left trim string (in place)
+ *
+ * @param pbuf Buffered string
+ * @return Boolean
+ */
+bool string_ltrim_self(String *pbuf) {
+    if (pbuf == NULL || *pbuf == NULL)
+        return false;
+
+    uint32_t pos1 = string_memltrim((*pbuf)->data, (*pbuf)->length);
+
+    return pos1 == 0 || string_right_self(pbuf, pos1);
+}
+
+/**
+ * @fn bool string_rtrim_self(String *pbuf)
+ * @brief Right trim string (in place)
+ *
+ * @param pbuf Buffered string
+ * @return Boolean
+ */
+bool string_rtrim_self(String *pbuf) {
+    if (pbuf == NULL || *pbuf == NULL)
+        return false;
+
+    uint32_t len = string_memrtrim((*pbuf)->data, (*pbuf)->length);
+
+    (*pbuf)->data[len] = '\0';
+    (*pbuf)->length = len;
+
+    return true;
+}
+
+/**
+ * @fn bool string_trim_self(String *pbuf)
+ * @brief Trim string (in place)
+ *
+ * @param pbuf Buffered string
+ * @return Boolean
+ */
+bool string_trim_self(String *pbuf) {
+    if (pbuf == NULL || *pbuf == NULL)
+        return false;
+
+    uint32_t pos1, len = string_trim_view(*pbuf, &pos1);
+
+    if (pos1 > 0)
+        memmove((*pbuf)->data, (*pbuf)->data + pos1, len);
+    (*pbuf)->data[len] = '\0';
+    (*pbuf)->length = len;
+
+    return true;
+}
+
+/**
+ * @fn bool string_splitl_self(String *pbuf, const char *search, String *right)
+ * @brief Split string: left part stays in place, right part is a new Buffered string
+ *
+ * @param pbuf Buffered string
+ * @param search string to search
+ * @param right Buffered string (right part)
+ * @return Boolean (false if not found)
+ */
+bool string_splitl_self(String *pbuf, const char *search, String *right) {
+    if (pbuf == NULL || *pbuf == NULL || search == NULL || right == NULL)
+        return false;
+
+    uint32_t pos = string_find_c(*pbuf, search, 0);
+    if (pos == STR_ERROR)
+        return false;
 
-    uint32_t buflen = buf->length;
+    *right = string_right(*pbuf, pos + strlen(search));
+    (*pbuf)->data[pos] = '\0';
+    (*pbuf)->length = pos;
 
-    String tmp = realloc(buf, BUF_MEM(newcap));
+    return true;
+}
 
-    if (!tmp)
+/**
+ * @fn bool string_splitr_self(String *pbuf, const char *search, String *left)
+ * @brief Split string: right part stays in place, left part is a new Buffered string
+ *
+ * @param pbuf Buffered string
+ * @param search string to search
+ * @param left Buffered string (left part)
+ * @return Boolean (false if not found)
+ */
+bool string_splitr_self(String *pbuf, const char *search, String *left) {
+    if (pbuf == NULL || *pbuf == NULL || search == NULL || left == NULL)
         return false;
 
-    // truncated
-    if (newcap < buflen) {
-        tmp->data[newcap] = 0;
-        tmp->length = newcap;
-    }
+    uint32_t pos = string_find_c(*pbuf, search, 0);
+    if (pos == STR_ERROR)
+        return false;
 
-    tmp->capacity = newcap;
-    *pbuf = tmp;
+    *left = string_new(pos);
+    memcpy((*left)->data, (*pbuf)->data, pos);
+    (*left)->data[pos] = '\0';
+    (*left)->length = pos;
 
-    return true;
+    return string_right_self(pbuf, pos + strlen(search));
 }
 
+///// small strings /////
+
 /**
- * @fn void string_move(String *to, String *from)
- * @brief Copy string and free from
+ * @fn String string_sso(string_sso_t *sso, const char *str, uint32_t len)
+ * @brief Copy string in inline storage (allocated if longer than STRING_SSO_CAP)
  *
- * @param to Buffered string
- * @param from Buffered string
+ * @param sso Inline storage
+ * @param str String (does not need to be null terminated)
+ * @param len Length
+ * @return Buffered string (release with string_sso_free)
  */
-uint32_t string_move(String *to, String *from) {
-    if (to == NULL || from == NULL || *to == NULL || *from == NULL)
-        return UINT32_MAX;
+String string_sso(string_sso_t *sso, const char *str, uint32_t len) {
+    String buf;
 
-    if ((*from)->length > (*to)->length)
-        if (!string_resize(to, (*from)->capacity))
-            return UINT32_MAX;
+    if (sso == NULL || str == NULL)
+        return NULL;
 
-    memcpy((*to), (*from), BUF_MEM((*from)->length));
-    (*to)->length = (*from)->length;
-    free(*from);
+    if (len <= STRING_SSO_CAP) {
+        buf = &(sso->str);
+        buf->capacity = STRING_SSO_CAP | STRING_INLINE;
+    } else if ((buf = string_new(len)) == NULL)
+        return NULL;
 
-    return 0;
+    memcpy(buf->data, str, len);
+    buf->data[len] = '\0';
+    buf->length = len;
+
+    return buf;
 }
 
 /**
- * @fn uint32_t string_copy(String *to, const char *from)
- * @brief Copy string
+ * @fn String string_new_c_sso(string_sso_t *sso, const char *str)
+ * @brief string_new_c in inline storage
  *
- * @param to Buffered string
- * @param from string
+ * @param sso Inline storage
+ * @param str String
+ * @return Buffered string (release with string_sso_free)
  */
-uint32_t string_copy(String *to, const char *from) {
-    if (to == NULL || *to == NULL || from == NULL)
-        return UINT32_MAX;
-
-    size_t lenf = strlen(from);
-    if (lenf > UINT32_MAX - 1)
-        return UINT32_MAX;
+String string_new_c_sso(string_sso_t *sso, const char *str) {
+    if (str == NULL || strlen(str) > UINT32_MAX - 1)
+        return NULL;
 
-    if (lenf > (*to)->length)
-        if (!string_resize(to, BUF_MEM(lenf)))
-            return UINT32_MAX;
+    return string_sso(sso, str, strlen(str));
+}
 
-    memcpy((*to)->data, from, lenf + 1);
-    (*to)->length = lenf;
+/**
+ * @fn String string_left_sso(string_sso_t *sso, const String buf, uint32_t pos)
+ * @brief string_left in inline storage
+ *
+ * @param sso Inline storage
+ * @param buf Buffered string
+ * @param pos Position
+ * @return Buffered string (release with string_sso_free)
+ */
+String string_left_sso(string_sso_t *sso, const String buf, uint32_t pos) {
+    if (buf == NULL || pos > buf->length)
+        return NULL;
 
-    return 0;
+    return string_sso(sso, buf->data, pos + 1);
 }
 
 /**
- * @fn const char* string_buf_data(const String buf)
- * @brief Return Data of Buffered string
+ * @fn String string_right_sso(string_sso_t *sso, const String buf, uint32_t pos)
+ * @brief string_right in inline storage
  *
+ * @param sso Inline storage
  * @param buf Buffered string
- * @return String
+ * @param pos Position
+ * @return Buffered string (release with string_sso_free)
  */
-const char* string_data(const String buf) {
-    if (buf == NULL)
+String string_right_sso(string_sso_t *sso, const String buf, uint32_t pos) {
+    if (buf == NULL || pos > buf->length)
         return NULL;
 
-    return buf->data;
+    return string_sso(sso, buf->data + pos, buf->length - pos);
 }
 
 /**
- * @fn void string_buf_reset(String buf)
- * @brief Reset Buffered string content
+ * @fn bool string_isinline(const string_sso_t *sso, const String buf)
+ * @brief Buffered string is in inline storage
  *
+ * @param sso Inline storage
  * @param buf Buffered string
+ * @return Boolean
  */
-void string_reset(String buf) {
-    if (buf == NULL)
-        return;
+bool string_isinline(const string_sso_t *sso, const String buf) {
+    return buf == &(sso->str);
+}
 
-    buf->length = 0;
-    buf->data[0] = 0;
+/**
+ * @fn void string_sso_free(string_sso_t *sso, String buf)
+ * @brief Free buffered string returned by *_sso functions (only if it is not inline)
+ *
+ * @param sso Inline storage
+ * @param buf Buffered string
+ */
+void string_sso_free(string_sso_t *sso, String buf) {
+    if (buf != &(sso->str))
+        string_free(buf);
 }
 
 ////////////////
 
-String _str_result_tmp_xxxxxxx_; /**< for move macros >**/
-
 /**
  * @fn String string_left(const String buf, uint32_t pos)
  * @brief Substring left from position
@@ -399,7 +1181,7 @@ String string_delete_prefix_c(const String buf, const char *pfx) {
 
     String prefix = string_new_c(pfx);
     String res = string_delete_prefix(buf, prefix);
-    free(prefix);
+    string_free(prefix);
 
     return res;
 }
@@ -446,7 +1228,7 @@ String string_delete_postfix_c(const String buf, const char *pfx) {
 
     String postfix = string_new_c(pfx);
     String res = string_delete_postfix(buf, postfix);
-    free(postfix);
+    string_free(postfix);
 
     return res;
 }
@@ -520,12 +1302,65 @@ String string_replace_c(const String buf, const char *c_search, const char *c_re
 
     String newstr = string_replace(buf, search, replace, pos);
 
-    free(search);
-    free(replace);
+    string_free(search);
+    string_free(replace);
 
     return newstr;
 }
 
+/**
+ * @fn String string_replace_all(const String buf, const char *c_search, const char *c_replace)
+ * @brief Replace all occurrences in one pass (one allocation of final length).
+ *        Matches are not overlapped and replaced text is not searched again, so the result differs
+ *        from repeating string_replace_c until not found when replacing creates new matches
+ *        ("    " with "  " -> " " gives "  ", the loop gives " ")
+ *
+ * @param buf Buffered string
+ * @param c_search String
+ * @param c_replace String
+ * @return Buffered string (NULL if not found)
+ */
+String string_replace_all(const String buf, const char *c_search, const char *c_replace) {
+    if (buf == NULL || c_search == NULL || c_replace == NULL || *c_search == '\0')
+        return NULL;
+
+    uint32_t slen = strlen(c_search), rlen = strlen(c_replace);
+    uint32_t qty = 0, r, w, p;
+
+    for (r = 0; (p = string_memfind(buf->data + r, buf->length - r, c_search, slen)) != STR_ERROR; r += p + slen)
+        ++qty;
+    if (qty == 0)
+        return NULL;
+
+    String new = string_new(buf->length - qty * slen + qty * rlen);
+    if (new == NULL)
+        return NULL;
+
+    for (r = w = 0; (p = string_memfind(buf->data + r, buf->length - r, c_search, slen)) != STR_ERROR; r += p + slen) {
+        memcpy(new->data + w, buf->data + r, p);
+        memcpy(new->data + w + p, c_replace, rlen);
+        w += p + rlen;
+    }
+    memcpy(new->data + w, buf->data + r, buf->length - r);
+    new->length = w + buf->length - r;
+    new->data[new->length] = '\0';
+
+    return new;
+}
+
+/**
+ * @fn String string_delete_all(const String buf, const char *str)
+ * @brief Delete all occurrences in one pass
+ *        (as string_replace_all: "aabb" without "ab" gives "ab", not "")
+ *
+ * @param buf Buffered string
+ * @param str String
+ * @return Buffered string (NULL if not found)
+ */
+String string_delete_all(const String buf, const char *str) {
+    return string_replace_all(buf, str, "");
+}
+
 /**
  * @fn uint32_t string_find(const String buf, const String search, uint32_t pos)
  * @brief Find substring.
@@ -539,11 +1374,9 @@ uint32_t string_find(const String buf, const String search, uint32_t pos) {
     if (buf == NULL || search == NULL || search->length > buf->length || pos > buf->length)
         return STR_ERROR;
 
-    char *p;
-    if ((p = strstr(buf->data + pos, search->data)) != NULL)
-        return (p - buf->data);
+    uint32_t p = string_memfind(buf->data + pos, buf->length - pos, search->data, search->length);
 
-    return STR_ERROR;
+    return p == STR_ERROR ? STR_ERROR : p + pos;
 }
 
 /**
@@ -559,11 +1392,174 @@ uint32_t string_find_c(const String buf, const char *csearch, uint32_t pos) {
     if (buf == NULL || csearch == NULL || pos > buf->length)
         return STR_ERROR;
 
-    String search = string_new_c(csearch);
-    uint32_t p = string_find(buf, search, pos);
-    free(search);
+    uint32_t p = string_memfind(buf->data + pos, buf->length - pos, csearch, strlen(csearch));
+
+    return p == STR_ERROR ? STR_ERROR : p + pos;
+}
+
+/**
+ * @fn uint32_t string_memfind(const char *buf, uint32_t len, const char *search, uint32_t search_len)
+ * @brief Find bytes in bytes (null characters are not terminators).
+ *        Candidates are found with memchr of first byte. When they fail too often (common first byte)
+ *        first and last byte of 64 (AVX2) or 32 (SSE2) positions are checked at once, memchr is kept
+ *        for the tail and on other targets
+ *
+ * @param buf Bytes
+ * @param len Length of bytes
+ * @param search Searched bytes
+ * @param search_len Length of searched bytes
+ * @return Position
+ */
+uint32_t string_memfind(const char *buf, uint32_t len, const char *search, uint32_t search_len) {
+    const char *p;
+    uint32_t n = 0, last, misses = 0;
+
+    if (search_len == 0)
+        return 0;
+    if (search_len > len)
+        return STR_ERROR;
+    if (search_len == 1)
+        return (p = memchr(buf, search[0], len)) == NULL ? STR_ERROR : p - buf;
+
+    // last candidate position
+    last = len - search_len;
+
+    // rare first byte: memchr is the fastest scan
+    for (; n <= last && misses < 8; ++misses, ++n) {
+        if ((p = memchr(buf + n, search[0], last - n + 1)) == NULL)
+            return STR_ERROR;
+        n = p - buf;
+        if (!memcmp(p + 1, search + 1, search_len - 1))
+            return n;
+    }
+
+#if defined(__AVX2__)
+    const __m256i first32 = _mm256_set1_epi8(search[0]);
+    const __m256i last32 = _mm256_set1_epi8(search[search_len - 1]);
+
+    // two vectors per iteration: 64 positions
+    for (; n <= last && last - n >= 63; n += 64) {
+        const char *b = buf + n, *e = buf + n + search_len - 1;
+        uint64_t mask = (uint32_t) _mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(first32, _mm256_loadu_si256((const __m256i*) b)),
+                        _mm256_cmpeq_epi8(last32, _mm256_loadu_si256((const __m256i*) e))));
+        mask |= (uint64_t) (uint32_t) _mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(first32, _mm256_loadu_si256((const __m256i*) (b + 32))),
+                        _mm256_cmpeq_epi8(last32, _mm256_loadu_si256((const __m256i*) (e + 32))))) << 32;
+
+        for (; mask != 0; mask &= mask - 1) {
+            uint32_t bit = __builtin_ctzll(mask);
+
+            if (!memcmp(b + bit + 1, search + 1, search_len - 2))
+                return n + bit;
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i first16 = _mm_set1_epi8(search[0]);
+    const __m128i last16 = _mm_set1_epi8(search[search_len - 1]);
+
+    // two vectors per iteration: 32 positions
+    for (; n <= last && last - n >= 31; n += 32) {
+        const char *b = buf + n, *e = buf + n + search_len - 1;
+        uint32_t mask = _mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(first16, _mm_loadu_si128((const __m128i*) b)),
+                        _mm_cmpeq_epi8(last16, _mm_loadu_si128((const __m128i*) e))));
+        mask |= (uint32_t) _mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(first16, _mm_loadu_si128((const __m128i*) (b + 16))),
+                        _mm_cmpeq_epi8(last16, _mm_loadu_si128((const __m128i*) (e + 16))))) << 16;
+
+        for (; mask != 0; mask &= mask - 1) {
+            uint32_t bit = __builtin_ctz(mask);
+
+            if (!memcmp(b + bit + 1, search + 1, search_len - 2))
+                return n + bit;
+        }
+    }
+#endif
+
+    while (n <= last) {
+        if ((p = memchr(buf + n, search[0], last - n + 1)) == NULL)
+            return STR_ERROR;
+        n = p - buf;
+        if (!memcmp(p + 1, search + 1, search_len - 1))
+            return n;
+        ++n;
+    }
+
+    return STR_ERROR;
+}
+
+/**
+ * @fn void string_memupper(char *dst, const char *src, uint32_t len)
+ * @brief ASCII bytes to upper case, 32 (AVX2) or 16 (SSE2) bytes at once. Other bytes are copied
+ *
+ * @param dst Destination (can be src)
+ * @param src Bytes
+ * @param len Length of bytes
+ */
+void string_memupper(char *dst, const char *src, uint32_t len) {
+    mem_fold(dst, src, len, 'a', 'z');
+}
+
+/**
+ * @fn void string_memlower(char *dst, const char *src, uint32_t len)
+ * @brief ASCII bytes to lower case, 32 (AVX2) or 16 (SSE2) bytes at once. Other bytes are copied
+ *
+ * @param dst Destination (can be src)
+ * @param src Bytes
+ * @param len Length of bytes
+ */
+void string_memlower(char *dst, const char *src, uint32_t len) {
+    mem_fold(dst, src, len, 'A', 'Z');
+}
+
+/**
+ * @fn int string_memcasecmp(const char *a, const char *b, uint32_t len)
+ * @brief Compare bytes ignoring ASCII case (as strncasecmp, null characters are not terminators)
+ *
+ * @param a Bytes
+ * @param b Bytes
+ * @param len Length of bytes
+ * @return <0, 0, >0 as first different lower case byte of a is lower, equal or greater than b
+ */
+int string_memcasecmp(const char *a, const char *b, uint32_t len) {
+    uint32_t n = 0;
+
+#if defined(__AVX2__)
+    for (; len - n >= 32; n += 32) {
+        __m256i va = fold_lower32(_mm256_loadu_si256((const __m256i*) (a + n)));
+        __m256i vb = fold_lower32(_mm256_loadu_si256((const __m256i*) (b + n)));
+        uint32_t mask = ~(uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb));
+
+        if (mask != 0) {
+            n += __builtin_ctz(mask);
+            break;
+        }
+    }
+#elif defined(__SSE2__)
+    for (; len - n >= 16; n += 16) {
+        __m128i va = fold_lower16(_mm_loadu_si128((const __m128i*) (a + n)));
+        __m128i vb = fold_lower16(_mm_loadu_si128((const __m128i*) (b + n)));
+        uint32_t mask = ~_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) & 0xffff;
+
+        if (mask != 0) {
+            n += __builtin_ctz(mask);
+            break;
+        }
+    }
+#endif
+
+    for (; n < len; n++) {
+        if (a[n] == b[n])
+            continue;
+
+        int ca = TO_LOWER((uint8_t) a[n]), cb = TO_LOWER((uint8_t) b[n]);
+
+        if (ca != cb)
+            return ca - cb;
+    }
 
-    return p;
+    return 0;
 }
 
 /**
@@ -578,13 +1574,7 @@ String string_toupper(const String buf) {
         return NULL;
 
     String new = string_new(buf->length);
-    for (int i = 0; i < buf->length; i++) {
-        if (buf->data[i] >= 97 && buf->data[i] <= 122)
-            new->data[i] = buf->data[i] - 32;
-        else
-            new->data[i] = buf->data[i];
-    }
-
+    string_memupper(new->data, buf->data, buf->length);
     new->length = buf->length;
 
     return new;
@@ -602,18 +1592,93 @@ String string_tolower(const String buf) {
         return NULL;
 
     String new = string_new(buf->length);
-    for (int i = 0; i < buf->length; i++) {
-        if (buf->data[i] >= 65 && buf->data[i] <= 90)
-            new->data[i] = buf->data[i] + 32;
-        else
-            new->data[i] = buf->data[i];
-    }
-
+    string_memlower(new->data, buf->data, buf->length);
     new->length = buf->length;
 
     return new;
 }
 
+/**
+ * @fn uint32_t string_memltrim(const char *buf, uint32_t len)
+ * @brief Leading white space ("C" locale isspace) of bytes, 32 (AVX2) or 16 (SSE2) bytes at once
+ *
+ * @param buf Bytes
+ * @param len Length of bytes
+ * @return Position of first byte that is not white space (len if none)
+ */
+uint32_t string_memltrim(const char *buf, uint32_t len) {
+    uint32_t n = 0, mask;
+
+#if defined(__AVX2__)
+    for (; len - n >= 32; n += 32) {
+        if ((mask = nonspace_mask32(buf + n)) != 0)
+            return n + __builtin_ctz(mask);
+    }
+#endif
+#if defined(__SSE2__)
+    // lines are short: 16 bytes also after AVX2
+    for (; len - n >= 16; n += 16) {
+        if ((mask = nonspace_mask16(buf + n)) != 0)
+            return n + __builtin_ctz(mask);
+    }
+#endif
+
+    while (n < len && IS_SPACE(buf[n]))
+        ++n;
+
+    return n;
+}
+
+/**
+ * @fn uint32_t string_memrtrim(const char *buf, uint32_t len)
+ * @brief Trailing white space ("C" locale isspace) of bytes, 32 (AVX2) or 16 (SSE2) bytes at once
+ *
+ * @param buf Bytes
+ * @param len Length of bytes
+ * @return Length without trailing white space (0 if all is white space)
+ */
+uint32_t string_memrtrim(const char *buf, uint32_t len) {
+    uint32_t mask;
+
+#if defined(__AVX2__)
+    for (; len >= 32; len -= 32) {
+        if ((mask = nonspace_mask32(buf + len - 32)) != 0)
+            return len - __builtin_clz(mask);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; len >= 16; len -= 16) {
+        if ((mask = nonspace_mask16(buf + len - 16)) != 0)
+            return len - 16 + 32 - __builtin_clz(mask);
+    }
+#endif
+
+    while (len > 0 && IS_SPACE(buf[len - 1]))
+        --len;
+
+    return len;
+}
+
+/**
+ * @fn uint32_t string_trim_view(const String buf, uint32_t *start)
+ * @brief Trim string without copy
+ *
+ * @param buf Buffered string
+ * @param start Position of first byte that is not white space
+ * @return Length of trimmed string (0 if blank)
+ */
+uint32_t string_trim_view(const String buf, uint32_t *start) {
+    *start = 0;
+    if (buf == NULL)
+        return 0;
+
+    uint32_t len = string_memrtrim(buf->data, buf->length);
+
+    *start = string_memltrim(buf->data, len);
+
+    return len - *start;
+}
+
 /**
  * @fn String string_ltrim(const String buf)
  * @brief Left trim string
@@ -625,15 +1690,11 @@ String string_ltrim(const String buf) {
     if (buf == NULL)
         return NULL;
 
-    uint32_t pos1 = 0;
-
-    while (pos1 < buf->length && isspace(buf->data[pos1]))
-        ++pos1;
+    uint32_t pos1 = string_memltrim(buf->data, buf->length);
 
-    String new = string_new(pos1 + (buf->length - 1) + 1);
-    memcpy(new->data, buf->data + pos1, (buf->length - 1) - pos1 + 1);
-
-    new->length = (buf->length - 1) - pos1 + 1;
+    String new = string_new(buf->length - pos1);
+    memcpy(new->data, buf->data + pos1, buf->length - pos1);
+    new->length = buf->length - pos1;
 
     return new;
 }
@@ -649,15 +1710,11 @@ String string_rtrim(const String buf) {
     if (buf == NULL)
         return NULL;
 
-    uint32_t pos2 = buf->length - 1;
-
-    while (pos2 >= 0 && isspace(buf->data[pos2]))
-        --pos2;
+    uint32_t len = string_memrtrim(buf->data, buf->length);
 
-    String new = string_new(pos2 + 1);
-    memcpy(new->data, buf->data, pos2 + 1);
-
-    new->length = pos2 + 1;
+    String new = string_new(len);
+    memcpy(new->data, buf->data, len);
+    new->length = len;
 
     return new;
 }
@@ -673,17 +1730,11 @@ String string_trim(const String buf) {
     if (buf == NULL)
         return NULL;
 
-    uint32_t pos1 = 0, pos2 = buf->length - 1;
-
-    while (pos1 < buf->length && isspace(buf->data[pos1]))
-        ++pos1;
-    while (pos2 >= 0 && isspace(buf->data[pos2]))
-        --pos2;
+    uint32_t pos1, len = string_trim_view(buf, &pos1);
 
-    String new = string_new(pos1 + pos2 + 1);
-    memcpy(new->data, buf->data + pos1, pos2 - pos1 + 1);
-
-    new->length = pos2 - pos1 + 1;
+    String new = string_new(len);
+    memcpy(new->data, buf->data + pos1, len);
+    new->length = len;
 
     return new;
 }
@@ -701,7 +1752,7 @@ uint32_t string_append(String buf, const char *fmt, ...) {
     if (buf == NULL || fmt == NULL)
         return 0;
 
-    const size_t spc = buf->capacity - buf->length;
+    const size_t spc = BUF_CAP(buf) - buf->length;
 
     if (!spc)
         return 0;
@@ -751,7 +1802,7 @@ uint32_t string_write(String buf, const char *fmt, ...) {
     if (buf == NULL || fmt == NULL)
         return 0;
 
-    const size_t cap = buf->capacity;
+    const size_t cap = BUF_CAP(buf);
 
     if (!cap)
         return 0;
@@ -810,6 +1861,53 @@ bool string_equals_c(const String a, const char *b) {
     return !memcmp(a->data, b, a->length);
 }
 
+/**
+ * @fn bool string_equals_nocase(const String a, const String b)
+ * @brief Compare strings equality ignoring ASCII case
+ *
+ * @param a Buffered string
+ * @param b Buffered string
+ * @return Boolean
+ */
+bool string_equals_nocase(const String a, const String b) {
+    if (a == NULL || b == NULL || a->length != b->length)
+        return false;
+
+    return !string_memcasecmp(a->data, b->data, a->length);
+}
+
+/**
+ * @fn bool string_equals_nocase_c(const String a, const char *b)
+ * @brief Compare strings equality ignoring ASCII case
+ *
+ * @param a Buffered string
+ * @param b String
+ * @return Boolean
+ */
+bool string_equals_nocase_c(const String a, const char *b) {
+    if (a == NULL || b == NULL || a->length != strlen(b))
+        return false;
+
+    return !string_memcasecmp(a->data, b, a->length);
+}
+
+/**
+ * @fn int string_compare_nocase(const String a, const String b)
+ * @brief Compare strings ignoring ASCII case (order of lower case bytes, shorter first on common prefix)
+ *
+ * @param a Buffered string
+ * @param b Buffered string
+ * @return <0, 0, >0 as a is lower, equal or greater than b
+ */
+int string_compare_nocase(const String a, const String b) {
+    if (a == NULL || b == NULL)
+        return (a != NULL) - (b != NULL);
+
+    int r = string_memcasecmp(a->data, b->data, a->length < b->length ? a->length : b->length);
+
+    return r != 0 ? r : (a->length > b->length) - (a->length < b->length);
+}
+
 ////////////////////////////////////////////////////////////
 
 /**
@@ -889,17 +1987,10 @@ bool string_isfloat(const String buf) {
  * @return Boolean
  */
 bool string_isblank(const String buf) {
-    char *ch;
-    bool is_blank = true;
-
-    for (ch = buf->data; *ch != '\0'; ++ch) {
-        if (!isspace(*ch)) {
-            is_blank = false;
-            break;
-        }
-    }
+    if (buf == NULL)
+        return false;
 
-    return is_blank;
+    return string_memltrim(buf->data, buf->length) == buf->length;
 }
 
 /**
@@ -951,9 +2042,9 @@ uint8_t string_isrealexp(const String buf) {
         ret = 2;
 
     if (left != NULL)
-        free(left);
+        string_free(left);
     if (right != NULL)
-        free(right);
+        string_free(right);
 
     return ret;
 }
@@ -1038,25 +2129,40 @@ uint32_t string_split_array(String buf, const char *search, String **array) {
     uint32_t arr_len = 0;
     uint32_t pos = 0;
 
-    if (string_find_c(buf, search, 0) != STR_ERROR)
-        (*array) = malloc(sizeof(String));
-    else
+    if (string_find_c(buf, search, 0) == STR_ERROR)
         return 0;
+    (*array) = NULL;
 
     while ((pos = string_find_c(buf, search, 0)) != STR_ERROR) {
-        (*array) = realloc((*array), (arr_len + 1) * sizeof(String));
+        (*array) = allocator.realloc(allocator.ctx, (*array), arr_len * sizeof(String), (arr_len + 1) * sizeof(String));
         (*array)[arr_len++] = string_left(buf, pos - 1);
         string_right_m(buf, pos + strlen(search));
     }
 
     if (buf->length > 1) {
-        (*array) = realloc((*array), (arr_len + 1) * sizeof(String));
+        (*array) = allocator.realloc(allocator.ctx, (*array), arr_len * sizeof(String), (arr_len + 1) * sizeof(String));
         (*array)[arr_len++] = string_new_c(buf->data);
     }
 
     return arr_len;
 }
 
+/**
+ * @fn void string_array_free(String *array, uint32_t len)
+ * @brief Free array of strings returned by string_split_array
+ *
+ * @param array Array of strings
+ * @param len Array length
+ */
+void string_array_free(String *array, uint32_t len) {
+    if (array == NULL)
+        return;
+
+    for (uint32_t n = 0; n < len; n++)
+        string_free(array[n]);
+    allocator.free(allocator.ctx, array, len * sizeof(String));
+}
+
 ////////////////////////////////////////////////////////////
 
 /**
@@ -1076,14 +2182,30 @@ string_hash_t string_hash(const String buf, uint8_t version, uint8_t key[16]) {
         return result;
     }
 
+    return string_hash_c(buf->data, buf->length, version, key);
+}
+
+/**
+ * @fn string_hash_t string_hash_c(const char *buf, uint32_t len, uint8_t version, uint8_t key[16])
+ * @brief Hash of char array (same result as string_hash of a String with the same content)
+ *
+ * @param buf Char array
+ * @param len Length of buf
+ * @param version enum STRING_HASH_VERSION
+ * @param key Key
+ * @return String hash result
+ */
+string_hash_t string_hash_c(const char *buf, uint32_t len, uint8_t version, uint8_t key[16]) {
+    string_hash_t result;
+
     const size_t lengths[4] = { 8, 16, 4, 8 };
-    int len = lengths[version];
-    result.outlen = len;
+    int outlen = lengths[version];
+    result.outlen = outlen;
 
     if (version < 2)
-        siphash(buf->data, buf->length, key, result.out, len);
+        siphash(buf, len, key, result.out, outlen);
     else
-        halfsiphash(buf->data, buf->length, key, result.out, len);
+        halfsiphash(buf, len, key, result.out, outlen);
 
     return result;
 }
@@ -35,6 +35,25 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+///// allocator /////
+
+/**
+ * @struct string_allocator_s
+ * @brief Memory functions (sizes are the ones of the allocation)
+ *
+ */
+typedef struct string_allocator_s {
+    void* (*alloc)(void *ctx, size_t size);                               /**< allocate >**/
+    void* (*realloc)(void *ctx, void *ptr, size_t old_size, size_t size); /**< resize (ptr NULL: allocate) >**/
+     void (*free)(void *ctx, void *ptr, size_t size);                     /**< release >**/
+     void *ctx;                                                           /**< allocator context >**/
+} string_allocator_t;                                                     /**< Allocator type >**/
+
+       void string_set_allocator(const string_allocator_t *hooks);
+const string_allocator_t* string_get_allocator(void);
+
+////////////////
+
 ///// core /////
 
 /**
@@ -43,18 +62,27 @@
  *
  */
 typedef struct string_s {
-    uint32_t capacity;    /**< capacity >**/
+    uint32_t capacity;    /**< capacity (| STRING_INLINE: storage not owned) >**/
     uint32_t length;      /**< current length >**/
         char data[];      /**< null-terminated string >**/
 } string_t;               /**< Buffered string internal type >**/
 typedef string_t *String; /**< Buffered string main type >**/
 
+/**
+ * @def STRING_INLINE
+ * @brief Flag of capacity: storage is not owned by allocator (inline string).
+ *        string_free ignores it and growing moves it to a new allocation
+ *
+ */
+#define STRING_INLINE 0x80000000u
+
      String string_new(const size_t cap);
      String string_new_c(const char *str);
      String string_dup(const String buf);
    uint32_t string_move(String *to, String *from);
    uint32_t string_copy(String *to, const char *from);
        bool string_resize(String *pbuf, const size_t newcap);
+       void string_free(String buf);
        void string_reset(String buf);
 const char* string_data(const String buf);
 
@@ -106,6 +134,8 @@ typedef struct string_hash_s string_hash_t; /**< hash result type >**/
        String string_delete_postfix_c(const String buf, const char *pfx);
        String string_replace(const String buf, const String search, String replace, uint32_t pos);
        String string_replace_c(const String buf, const char *c_search, const char *c_replace, uint32_t pos);
+       String string_replace_all(const String buf, const char *c_search, const char *c_replace);
+       String string_delete_all(const String buf, const char *str);
        String string_toupper(const String buf);
        String string_tolower(const String buf);
        String string_ltrim(const String buf);
@@ -113,13 +143,24 @@ typedef struct string_hash_s string_hash_t; /**< hash result type >**/
        String string_trim(const String buf);
        String string_split(const String buf, const char *search, String *right);
      uint32_t string_split_array(String buf, const char *search, String **array);
+         void string_array_free(String *array, uint32_t len);
 
      uint32_t string_find(const String buf, const String search, uint32_t pos);
      uint32_t string_find_c(const String buf, const char *csearch, uint32_t pos);
+     uint32_t string_memfind(const char *buf, uint32_t len, const char *search, uint32_t search_len);
+         void string_memupper(char *dst, const char *src, uint32_t len);
+         void string_memlower(char *dst, const char *src, uint32_t len);
+          int string_memcasecmp(const char *a, const char *b, uint32_t len);
+     uint32_t string_memltrim(const char *buf, uint32_t len);
+     uint32_t string_memrtrim(const char *buf, uint32_t len);
+     uint32_t string_trim_view(const String buf, uint32_t *start);
      uint32_t string_append(String buf, const char *fmt, ...);
      uint32_t string_write(String buf, const char *fmt, ...);
          bool string_equals(const String str1, const String str2);
          bool string_equals_c(const String a, const char *b);
+         bool string_equals_nocase(const String a, const String b);
+         bool string_equals_nocase_c(const String a, const char *b);
+          int string_compare_nocase(const String a, const String b);
          bool string_issigned(const String buf);
          bool string_isinteger(const String buf);
          bool string_isfloat(const String buf);
@@ -129,190 +170,218 @@ typedef struct string_hash_s string_hash_t; /**< hash result type >**/
          long string_tolong(const String buf, uint8_t base);
        double string_todouble(const String buf);
 string_hash_t string_hash(const String buf, uint8_t version, uint8_t key[16]);
+string_hash_t string_hash_c(const char *buf, uint32_t len, uint8_t version, uint8_t key[16]);
+
+///// in place /////
+
+// Functions *_self and macros *_m may move the string when it grows (`*pbuf` is updated).
+// The argument must be owned by the allocator (string_new...) or be inline (STRING_INLINE, moved to a new allocation)
+
+       bool string_left_self(String *pbuf, uint32_t pos);
+       bool string_right_self(String *pbuf, uint32_t pos);
+       bool string_mid_self(String *pbuf, uint32_t left, uint32_t right);
+       bool string_concat_self(String *pbuf, const String str2);
+       bool string_insert_self(String *pbuf, const String str, uint32_t pos);
+       bool string_delete_self(String *pbuf, uint32_t pos1, uint32_t pos2);
+       bool string_delete_c_self(String *pbuf, const char *str);
+       bool string_delete_prefix_self(String *pbuf, const String pfx);
+       bool string_delete_prefix_c_self(String *pbuf, const char *pfx);
+       bool string_delete_postfix_self(String *pbuf, const String pfx);
+       bool string_delete_postfix_c_self(String *pbuf, const char *pfx);
+       bool string_replace_self(String *pbuf, const String search, const String replace, uint32_t pos);
+       bool string_replace_c_self(String *pbuf, const char *c_search, const char *c_replace, uint32_t pos);
+       bool string_replace_all_self(String *pbuf, const char *c_search, const char *c_replace);
+       bool string_delete_all_self(String *pbuf, const char *str);
+       bool string_toupper_self(String *pbuf);
+       bool string_tolower_self(String *pbuf);
+       bool string_ltrim_self(String *pbuf);
+       bool string_rtrim_self(String *pbuf);
+       bool string_trim_self(String *pbuf);
+       bool string_splitl_self(String *pbuf, const char *search, String *right);
+       bool string_splitr_self(String *pbuf, const char *search, String *left);
+
+///// small strings /////
 
-////////////////
+/**
+ * @def STRING_SSO_CAP
+ * @brief Capacity of inline strings
+ *
+ */
+#define STRING_SSO_CAP 23
+
+/**
+ * @union string_sso_u
+ * @brief Inline storage of a short string (on stack or inside owning struct).
+ *        `&sso.str` is a String for any string_* function. Resizing it (also by *_self or *_m)
+ *        moves it to a new allocation, so release with string_sso_free or string_free
+ *
+ */
+typedef union string_sso_u {
+    string_t str;                                    /**< header, data is inline >**/
+        char mem[sizeof(string_t) + STRING_SSO_CAP + 1]; /**< storage >**/
+} string_sso_t;                                      /**< Inline string type >**/
+
+     String string_sso(string_sso_t *sso, const char *str, uint32_t len);
+     String string_new_c_sso(string_sso_t *sso, const char *str);
+     String string_left_sso(string_sso_t *sso, const String buf, uint32_t pos);
+     String string_right_sso(string_sso_t *sso, const String buf, uint32_t pos);
+       bool string_isinline(const string_sso_t *sso, const String buf);
+       void string_sso_free(string_sso_t *sso, String buf);
 
-extern String _str_result_tmp_xxxxxxx_;
+////////////////
 
 /**
  * @def string_left_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_left_m(buf, pos)                                                                 \
-            _str_result_tmp_xxxxxxx_ = string_left((buf), (pos));                               \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_left_m(buf, pos) string_left_self(&(buf), (pos))
 
 /**
  * @def string_right_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_right_m(buf, pos)                                                                \
-            _str_result_tmp_xxxxxxx_ = string_right((buf), (pos));                              \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_right_m(buf, pos) string_right_self(&(buf), (pos))
 
 /**
  * @def string_mid_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_mid_m(buf,left,right)                                                            \
-            _str_result_tmp_xxxxxxx_ = string_mid((buf), (left), (right));                      \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_mid_m(buf, left, right) string_mid_self(&(buf), (left), (right))
 
 /**
  * @def string_concat_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_concat_m(buf,str2)                                                               \
-            _str_result_tmp_xxxxxxx_ = string_concat((buf), (str2));                            \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_concat_m(buf, str2) string_concat_self(&(buf), (str2))
 
 /**
  * @def string_insert_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_insert_m(buf,str,pos)                                                            \
-            _str_result_tmp_xxxxxxx_ = string_insert((buf), (str), (pos));                      \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_insert_m(buf, str, pos) string_insert_self(&(buf), (str), (pos))
 
 /**
  * @def string_delete_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_delete_m(buf,pos1,pos2)                                                          \
-            _str_result_tmp_xxxxxxx_ = string_delete((buf), (pos1), (pos2));                    \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_delete_m(buf, pos1, pos2) string_delete_self(&(buf), (pos1), (pos2))
 
 /**
  * @def string_delete_c_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_delete_c_m(buf,str)                                                              \
-            _str_result_tmp_xxxxxxx_ = string_delete_c((buf), (str));                           \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_delete_c_m(buf, str) string_delete_c_self(&(buf), (str))
 
 /**
  * @def string_delete_prefix_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_delete_prefix_m(buf,str)                                                         \
-            _str_result_tmp_xxxxxxx_ = string_delete_prefix((buf), (str));                      \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_delete_prefix_m(buf, str) string_delete_prefix_self(&(buf), (str))
 
 /**
  * @def string_delete_prefix_c_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_delete_prefix_c_m(buf,str)                                                       \
-            _str_result_tmp_xxxxxxx_ = string_delete_prefix_c((buf), (str));                    \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
-
+#define string_delete_prefix_c_m(buf, str) string_delete_prefix_c_self(&(buf), (str))
 
 /**
  * @def string_delete_postfix_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_delete_postfix_m(buf,str)                                                        \
-            _str_result_tmp_xxxxxxx_ = string_delete_postfix((buf), (str));                     \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_delete_postfix_m(buf, str) string_delete_postfix_self(&(buf), (str))
 
 /**
  * @def string_delete_postfix_c_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_delete_postfix_c_m(buf,str)                                                      \
-            _str_result_tmp_xxxxxxx_ = string_delete_postfix_c((buf), (str));                   \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_delete_postfix_c_m(buf, str) string_delete_postfix_c_self(&(buf), (str))
 
 /**
  * @def string_replace_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_replace_m(buf,search,replace,pos)                                                \
-            _str_result_tmp_xxxxxxx_ = string_replace((buf), (search), (replace), (pos));       \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_replace_m(buf, search, replace, pos) string_replace_self(&(buf), (search), (replace), (pos))
 
 /**
  * @def string_replace_c_m
- * @brief Return to self
+ * @brief Return to self (in place)
+ *
+ */
+#define string_replace_c_m(buf, c_search, c_replace, pos) string_replace_c_self(&(buf), (c_search), (c_replace), (pos))
+
+/**
+ * @def string_replace_all_m
+ * @brief Return to self (in place)
+ *
+ */
+#define string_replace_all_m(buf, c_search, c_replace) string_replace_all_self(&(buf), (c_search), (c_replace))
+
+/**
+ * @def string_delete_all_m
+ * @brief Return to self (in place)
  *
  */
-#define string_replace_c_m(buf,c_search,c_replace,pos)                                          \
-            _str_result_tmp_xxxxxxx_ = string_replace_c((buf), (c_search), (c_replace), (pos)); \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_delete_all_m(buf, str) string_delete_all_self(&(buf), (str))
 
 /**
  * @def string_toupper_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_toupper_m(buf)                                                                   \
-            _str_result_tmp_xxxxxxx_ = string_toupper((buf));                                   \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_toupper_m(buf) string_toupper_self(&(buf))
 
 /**
  * @def string_tolower_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_tolower_m(buf)                                                                   \
-            _str_result_tmp_xxxxxxx_ = string_tolower((buf));                                   \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_tolower_m(buf) string_tolower_self(&(buf))
 
 /**
  * @def string_ltrim_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_ltrim_m(buf)                                                                     \
-            _str_result_tmp_xxxxxxx_ = string_ltrim((buf));                                     \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_ltrim_m(buf) string_ltrim_self(&(buf))
 
 /**
  * @def string_rtrim_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_rtrim_m(buf)                                                                     \
-            _str_result_tmp_xxxxxxx_ = string_rtrim((buf));                                     \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_rtrim_m(buf) string_rtrim_self(&(buf))
 
 /**
  * @def string_trim_m
- * @brief Return to self
+ * @brief Return to self (in place)
  *
  */
-#define string_trim_m(buf)                                                                      \
-            _str_result_tmp_xxxxxxx_ = string_trim((buf));                                      \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_trim_m(buf) string_trim_self(&(buf))
 
 /**
  * @def string_splitr_m
- * @brief Return right to self
+ * @brief Return right to self (in place)
  *
  */
-#define string_splitr_m(buf, search, left)                                                      \
-		    (left) = string_split((buf), (search), (&_str_result_tmp_xxxxxxx_));                \
-		    string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_splitr_m(buf, search, left) string_splitr_self(&(buf), (search), &(left))
 
 /**
  * @def string_splitl_m
- * @brief Return left to self
+ * @brief Return left to self (in place)
  *
  */
-#define string_splitl_m(buf, search, right)                                                     \
-		    _str_result_tmp_xxxxxxx_ = string_split((buf), (search), (&right));                 \
-            string_move(&(buf), &_str_result_tmp_xxxxxxx_)
+#define string_splitl_m(buf, search, right) string_splitl_self(&(buf), (search), &(right))
 
 #endif /* STRINGS_H_ */
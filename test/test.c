@@ -30,30 +30,238 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
 
 #include "il_parser.h"
+#include "il_program.h"
+
+static const char test_errors[] =
+        "    LD %IX0.256\n"
+        "    JMP nowhere\n"
+        "    LD D#2023-13-01\n"
+        "    ADD 5\n"
+        "    LD SINT#200\n"
+        "    CAL FUNC (2, A:=1)\n"
+        "    ST %QX0.0\n"
+        "    CAL FUNC2(\n"
+        "        A:=1,\n"
+        "(* not closed\n";
+
+static const char test_decls[] =
+        "    VAR\n"
+        "        X: BOOL;\n"
+        "        I: INT;\n"
+        "        D: DINT;\n"
+        "        L: LINT;\n"
+        "        R: REAL;\n"
+        "        LR: LREAL;\n"
+        "        T: TIME;\n"
+        "        DA: DATE;\n"
+        "        TD: TOD;\n"
+        "        DAT: DT;\n"
+        "        S: STRING;\n"
+        "        TMR: TON;\n"
+        "        CNT: CTU;\n"
+        "    END_VAR\n";
+
+// storage of test_decls variables
+static const struct {
+    uint32_t size;  //
+    uint32_t align; //
+} test_decls_layout[] = {
+    { 1, 1 }, // BOOL
+    { 2, 2 }, // INT
+    { 4, 4 }, // DINT
+    { 8, 8 }, // LINT
+    { 4, 4 }, // REAL
+    { 8, 8 }, // LREAL
+    { 4, 4 }, // TIME
+    { 4, 4 }, // DATE
+    { 4, 4 }, // TOD
+    { 8, 8 }, // DT
+    { 0, 0 }, // STRING: defined by runtime
+    { 0, 0 }, // TON: function block instance
+    { 0, 0 }, // CTU: function block instance
+};
+
+// packed instructions must keep the parsed values
+static uint32_t packed_mismatches(const parsed_il_t *parsed, const il_program_t *program) {
+    uint32_t errors = 0;
+
+    for (uint32_t n = 0; n < program->len; n++) {
+        const il_t *il = &(parsed->code[n]);
+        const il_ins_t *ins = &(program->code[n]);
+
+        if (ins->code != il->code || ins->datatype != il->iec_datatype
+                || !!(ins->flags & IL_F_C) != il->c || !!(ins->flags & IL_F_N) != il->n || !!(ins->flags & IL_F_P) != il->p)
+            ++errors;
+
+        switch (il->lit_dataformat) {
+            case LIT_INTEGER:
+                errors += ins->imm.integer != il->data.integer;
+                break;
+            case LIT_PHY:
+                errors += ins->aux != (il->data.phy.prefix | il->data.phy.datatype << 8);
+                break;
+            case LIT_STRING:
+                errors += strcmp(il_program_str(program, ins->imm.str), il->data.str->data) != 0;
+                break;
+            case LIT_VAR:
+                errors += strcmp(il_program_symbol(program, ins->imm.sym), il->data.str->data) != 0
+                        || il->data.str != parsed->symbols.name[il_symbols_find(&(parsed->symbols), il->data.str->data, il->data.str->length)];
+                break;
+            case LIT_CAL:
+                errors += strcmp(il_program_symbol(program, ins->imm.cal.func), il->data.cal.func->data) != 0 || ins->aux != il->data.cal.len;
+                for (uint32_t a = 0; a < ins->aux; a++) {
+                    const il_arg_t *arg = &(program->args[ins->imm.cal.arg + a]);
+                    errors += strcmp(il_program_symbol(program, arg->var), il->data.cal.arg[a].var->data) != 0 || arg->value.format != il->data.cal.arg[a].value.lit_dataformat;
+                }
+                break;
+            case LIT_VAD:
+                errors += ins->format != (il->data.vad.section == IL_VAR_OUTPUT ? LIT_VAO : LIT_VAD) || ins->aux != il->data.vad.len;
+                for (uint32_t d = 0; d < ins->aux; d++) {
+                    const il_decl_t *decl = &(program->decls[ins->imm.decl + d]);
+                    const il_var_decl_t *var = &(il->data.vad.var[d]);
+                    errors += strcmp(il_program_symbol(program, decl->type), var->type->data) != 0 || var->name != parsed->symbols.name[var->name_id]
+                            || decl->datatype != var->datatype || decl->size != var->size || decl->section != il->data.vad.section;
+                }
+                break;
+            default:
+                break;
+        }
+
+        if (il->code == IL_JMP)
+            errors += ins->imm.jmp_addr != il->data.jmp_addr;
+    }
+
+    return errors;
+}
+
+// allocator of test 5: calls and bytes in use (released sizes must match allocated ones)
+typedef struct mem_count_s {
+    uint64_t calls;  // alloc and realloc
+     int64_t in_use; //
+} mem_count_t;
+
+static void* count_alloc(void *ctx, size_t size) {
+    ++((mem_count_t*) ctx)->calls;
+    ((mem_count_t*) ctx)->in_use += size;
+
+    return malloc(size);
+}
+
+static void* count_realloc(void *ctx, void *ptr, size_t old_size, size_t size) {
+    ++((mem_count_t*) ctx)->calls;
+    ((mem_count_t*) ctx)->in_use += size - old_size;
+
+    return realloc(ptr, size);
+}
+
+static void count_free(void *ctx, void *ptr, size_t size) {
+    ((mem_count_t*) ctx)->in_use -= size;
+    free(ptr);
+}
+
+static const char *mem_phase_str[] = {
+    "load",     // IL_MEM_LOAD
+    "lexer",    // IL_MEM_LEXER
+    "labels",   // IL_MEM_LABELS
+    "literals", // IL_MEM_LITERALS
+};
 
 int main(void) {
+    const char *files[] = { "test1.il", "test2.il" };
+    il_program_t program;
     parsed_il_t parsed;
+    il_status_t status;
 
     printf("------------------ test 1 ------------------\n");
-    parse_file_il("test1.il", &parsed);
+    parse_file_il("test1.il", &parsed, &il_console_listener);
     printf("[lines = %d]\n", parsed.lines);
 
-    for (int n = 0; n < parsed.lines; n++) {
-        free_il(&(parsed.result[n]));
-    }
-    free(parsed.result);
+    free_parsed_il(&parsed);
     printf("--------------------------------------------\n");
     printf("\n");
     printf("------------------ test 2 ------------------\n");
-    parse_file_il("test2.il", &parsed);
+    parse_file_il("test2.il", &parsed, &il_console_listener);
     printf("[lines = %d]\n", parsed.lines);
 
+    free_parsed_il(&parsed);
+    printf("--------------------------------------------\n");
+    printf("\n");
+    printf("------------------ test 3 ------------------\n");
+    status = parse_buffer_il(test_errors, sizeof(test_errors) - 1, &parsed, &il_console_listener);
+    printf("[lines = %d, status = %d]\n", parsed.lines, status);
+
+    for (uint32_t n = 0; n < parsed.diag_qty; n++)
+        printf("    [line: %d, column: %d] %s\n", parsed.diag[n].line, parsed.diag[n].column, parsed.diag[n].message->data);
+    free_parsed_il(&parsed);
+    printf("--------------------------------------------\n");
+    printf("\n");
+    printf("------------------ test 4 ------------------\n");
+    printf("[instruction size: il_t = %zu bytes, packed = %zu bytes]\n", sizeof(il_t), sizeof(il_ins_t));
+    for (uint32_t n = 0; n < 2; n++) {
+        parse_file_il((char*) files[n], &parsed, NULL);
+        il_program_pack(&parsed, &program);
+        printf("[%s: %d instructions, %d symbols, parsed: %zu bytes, packed: %zu bytes, mismatches: %d]\n", files[n], parsed.lines, parsed.symbols.qty,
+                parsed.lines * sizeof(il_t) + parsed.arena.allocated, il_program_size(&program), packed_mismatches(&parsed, &program));
+        free_parsed_il(&parsed);
+        il_program_free(&program);
+    }
+    printf("--------------------------------------------\n");
+    printf("\n");
+    printf("------------------ test 5 ------------------\n");
+    mem_count_t count = { 0 };
+    il_allocator_t allocator = { count_alloc, count_realloc, count_free, &count };
+    il_parser_t *parser;
+    il_t *il;
+    uint32_t line, jmp_addr;
+
+    il_set_allocator(&allocator);
+    for (uint32_t n = 0; n < 2; n++) {
+        count.calls = 0;
+        parse_file_il((char*) files[n], &parsed, NULL);
+        printf("[%s: allocations: %" PRIu64 " (hooks: %" PRIu64 "), requested: %" PRIu64 " bytes, peak: %" PRIu64 " bytes]\n", files[n],
+                parsed.mem.allocs, count.calls, parsed.mem.bytes, parsed.mem.peak);
+        for (uint32_t p = 0; p < IL_MEM_PHASES; p++)
+            printf("    [%-8s: allocations: %" PRIu64 ", requested: %" PRIu64 " bytes, peak: %" PRIu64 " bytes]\n", mem_phase_str[p],
+                    parsed.mem.phase[p].allocs, parsed.mem.phase[p].bytes, parsed.mem.phase[p].peak);
+        free_parsed_il(&parsed);
+        printf("    [in use after free: %" PRId64 " bytes]\n", count.in_use);
+    }
+
+    // instructions in heap
+    parser = il_parser_open("test2.il", NULL);
+    while (il_parser_next(parser, &il)) {
+        while (il_parser_fixup(parser, &line, &jmp_addr))
+            ;
+        free_il(&il);
+    }
+    printf("[test2.il (iterator): allocations: %" PRIu64 ", peak: %" PRIu64 " bytes]\n", il_parser_mem(parser)->allocs, il_parser_mem(parser)->peak);
+    il_parser_close(parser);
+    printf("    [in use after close: %" PRId64 " bytes]\n", count.in_use);
+    il_set_allocator(NULL);
+    printf("--------------------------------------------\n");
+    printf("\n");
+    printf("------------------ test 6 ------------------\n");
+    uint32_t mismatches = 0, qty = 0;
+
+    parse_buffer_il(test_decls, sizeof(test_decls) - 1, &parsed, NULL);
     for (int n = 0; n < parsed.lines; n++) {
-        free_il(&(parsed.result[n]));
+        if (parsed.code[n].lit_dataformat != LIT_VAD)
+            continue;
+        for (uint32_t d = 0; d < parsed.code[n].data.vad.len; d++, qty++) {
+            const il_var_decl_t *var = &(parsed.code[n].data.vad.var[d]);
+
+            printf("[%-6s: size: %u, align: %u]\n", var->type->data, var->size, var->align);
+            if (qty >= sizeof(test_decls_layout) / sizeof(test_decls_layout[0])
+                    || var->size != test_decls_layout[qty].size || var->align != test_decls_layout[qty].align)
+                ++mismatches;
+        }
     }
-    free(parsed.result);
+    free_parsed_il(&parsed);
+    printf("[declarations: %u, layout mismatches: %u]\n", qty, mismatches + (qty != sizeof(test_decls_layout) / sizeof(test_decls_layout[0])));
     printf("--------------------------------------------\n");
 
     return 0;
@@ -0,0 +1,286 @@
+/**
+ * @file test_strings.c
+ * @brief Check stringslib functions against expected results
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Build (from repository root):
+ *   gcc -O2 -Istringslib -Istringslib/siphash stringslib/strings.c stringslib/siphash/siphash.c stringslib/siphash/halfsiphash.c \
+ *       test/test_strings.c -o test_strings
+ *
+ * Run:
+ *   ./test_strings
+ *
+ * Prints every failed check and exits with 1 if there was any.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "strings.h"
+
+static long checks = 0, failures = 0;
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        ++checks;                                                            \
+        if (!(cond)) {                                                       \
+            ++failures;                                                      \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);           \
+        }                                                                    \
+    } while (0)
+
+// buffered string content is exactly `expected`
+static bool is(const String buf, const char *expected) {
+    return buf != NULL && buf->length == strlen(expected) && strcmp(buf->data, expected) == 0;
+}
+
+///// small strings /////
+
+static void test_sso(void) {
+    string_sso_t sso, sso2;
+    String s, t, big;
+
+    // stays inline
+    s = string_new_c_sso(&sso, "abc");
+    CHECK(string_isinline(&sso, s));
+    CHECK(is(s, "abc"));
+    t = string_new_c("def");
+    CHECK(string_concat_m(s, t));
+    CHECK(string_isinline(&sso, s));
+    CHECK(is(s, "abcdef"));
+    string_free(t);
+
+    // grows out of inline storage through a _m macro
+    big = string_new_c("0123456789012345678901234567");
+    CHECK(string_concat_m(s, big));
+    CHECK(!string_isinline(&sso, s));
+    CHECK(is(s, "abcdef0123456789012345678901234567"));
+    CHECK(string_toupper_m(s));
+    CHECK(string_replace_all_m(s, "0123", "<>"));
+    CHECK(is(s, "ABCDEF<>456789<>456789<>4567"));
+    string_sso_free(&sso, s);
+
+    // string_free ignores inline strings
+    s = string_new_c_sso(&sso, "abc");
+    string_free(s);
+    CHECK(is(s, "abc"));
+
+    // shrink keeps it inline, insert moves it
+    s = string_new_c_sso(&sso, "0123456789");
+    CHECK(string_resize(&s, 4));
+    CHECK(string_isinline(&sso, s));
+    CHECK(is(s, "0123"));
+    CHECK(string_insert_m(s, big, 2));
+    CHECK(!string_isinline(&sso, s));
+    CHECK(is(s, "010123456789012345678901234567" "23"));
+    string_free(s);
+
+    // copies are heap strings
+    s = string_new_c_sso(&sso, "abc");
+    t = string_dup(s);
+    CHECK(is(t, "abc"));
+    CHECK(string_concat_m(t, big));
+    CHECK(is(t, "abc0123456789012345678901234567"));
+    string_free(t);
+
+    // move into an inline string
+    t = string_new_c_sso(&sso2, "xy");
+    CHECK(string_move(&t, &big) == 0);
+    CHECK(is(t, "0123456789012345678901234567"));
+    CHECK(!string_isinline(&sso2, t));
+    string_sso_free(&sso2, t);
+}
+
+///// in place /////
+
+// `expected` NULL: call must fail and leave the string unmodified
+#define SELF(input, call, expected)                                          \
+    do {                                                                     \
+        String buf = string_new_c(input);                                    \
+        bool ok = call;                                                      \
+        CHECK(ok == ((expected) != NULL));                                   \
+        CHECK(is(buf, (expected) != NULL ? (const char*) (expected) : input)); \
+        string_free(buf);                                                    \
+    } while (0)
+
+static void test_self(void) {
+    String ins = string_new_c("__"), pfx = string_new_c("LD"), sfx = string_new_c(");");
+    String srch = string_new_c("IX"), repl = string_new_c("QX"), part;
+
+    SELF("LD %IX0.1", string_left_self(&buf, 1), "LD");
+    SELF("LD %IX0.1", string_left_self(&buf, 8), "LD %IX0.1");
+    SELF("LD %IX0.1", string_left_self(&buf, 10), NULL);
+    SELF("LD %IX0.1", string_right_self(&buf, 3), "%IX0.1");
+    SELF("LD %IX0.1", string_right_self(&buf, 9), "");
+    SELF("LD %IX0.1", string_right_self(&buf, 10), NULL);
+    SELF("LD %IX0.1", string_mid_self(&buf, 4, 6), "%IX");
+    SELF("LD %IX0.1", string_mid_self(&buf, 0, 6), NULL);
+    SELF("LD %IX0.1", string_mid_self(&buf, 4, 10), NULL);
+    SELF("LD", string_concat_self(&buf, ins), "LD__");
+    SELF("LD", string_concat_self(&buf, buf), "LDLD");
+    SELF("LD", string_insert_self(&buf, ins, 0), "__LD");
+    SELF("LD", string_insert_self(&buf, ins, 1), "L__D");
+    SELF("LD", string_insert_self(&buf, ins, 2), "LD__");
+    SELF("LD", string_insert_self(&buf, ins, 3), NULL);
+    SELF("LD", string_insert_self(&buf, buf, 0), NULL);
+    SELF("LD %IX0.1", string_delete_self(&buf, 2, 3), "LDIX0.1");
+    SELF("LD %IX0.1", string_delete_self(&buf, 0, 8), "");
+    SELF("LD %IX0.1", string_delete_self(&buf, 3, 9), NULL);
+    SELF("LD %IX0.1 %IX", string_delete_c_self(&buf, "%IX"), "LD 0.1 %IX");
+    SELF("LD %IX0.1", string_delete_c_self(&buf, "%QX"), NULL);
+    SELF("LD %IX0.1", string_delete_prefix_self(&buf, pfx), " %IX0.1");
+    SELF("ST %IX0.1", string_delete_prefix_self(&buf, pfx), NULL);
+    SELF("LD %IX0.1", string_delete_prefix_c_self(&buf, "LD "), "%IX0.1");
+    SELF("L", string_delete_prefix_c_self(&buf, "LD"), NULL);
+    SELF("CAL F(A:=1);", string_delete_postfix_self(&buf, sfx), "CAL F(A:=1");
+    SELF("CAL F(A:=1)", string_delete_postfix_self(&buf, sfx), NULL);
+    SELF("CAL F(A:=1);", string_delete_postfix_c_self(&buf, "1);"), "CAL F(A:=");
+    SELF("CAL F(A:=1);", string_delete_postfix_c_self(&buf, ""), NULL);
+    SELF("LD %IX0.1 %IX0.2", string_replace_self(&buf, srch, repl, 0), "LD %QX0.1 %IX0.2");
+    SELF("LD %IX0.1 %IX0.2", string_replace_self(&buf, srch, repl, 5), "LD %IX0.1 %QX0.2");
+    SELF("LD %IX0.1", string_replace_self(&buf, srch, buf, 0), NULL);
+    SELF("LD %IX0.1", string_replace_c_self(&buf, "%IX0.1", "%MW10.0.1", 0), "LD %MW10.0.1");
+    SELF("LD %IX0.1", string_replace_c_self(&buf, "LD ", "", 0), "%IX0.1");
+    SELF("LD %IX0.1", string_replace_c_self(&buf, "IX", "QX", 5), NULL);
+    SELF("ld %ix0.1", string_toupper_self(&buf), "LD %IX0.1");
+    SELF("LD %IX0.1", string_tolower_self(&buf), "ld %ix0.1");
+    SELF(" \t LD %IX0.1 \r\n", string_ltrim_self(&buf), "LD %IX0.1 \r\n");
+    SELF(" \t LD %IX0.1 \r\n", string_rtrim_self(&buf), " \t LD %IX0.1");
+    SELF(" \t LD %IX0.1 \r\n", string_trim_self(&buf), "LD %IX0.1");
+    SELF(" \t \r\n", string_trim_self(&buf), "");
+    SELF("", string_trim_self(&buf), "");
+
+    SELF("A:=1, B:=2", string_splitl_self(&buf, ", ", &part), "A:=1");
+    CHECK(is(part, "B:=2"));
+    string_free(part);
+    SELF("A:=1, B:=2", string_splitr_self(&buf, ", ", &part), "B:=2");
+    CHECK(is(part, "A:=1"));
+    string_free(part);
+    SELF("A:=1", string_splitl_self(&buf, ", ", &part), NULL);
+    SELF("A:=1", string_splitr_self(&buf, ", ", &part), NULL);
+
+    // _m macros update the variable
+    String buf = string_new_c("LD");
+    for (int n = 0; n < 100; n++)
+        CHECK(string_concat_m(buf, ins));
+    CHECK(buf->length == 202);
+    CHECK(string_replace_c_m(buf, "LD", "ST", 0));
+    CHECK(string_delete_prefix_c_m(buf, "ST"));
+    CHECK(string_delete_all_m(buf, "_"));
+    CHECK(is(buf, ""));
+    string_free(buf);
+
+    string_free(ins);
+    string_free(pfx);
+    string_free(sfx);
+    string_free(srch);
+    string_free(repl);
+}
+
+///// replace all /////
+
+// naive reference: strstr from the end of previous replacement (NULL if not found)
+static char* replace_all_ref(const char *str, const char *search, const char *replace) {
+    size_t slen = strlen(search), rlen = strlen(replace), qty = 0;
+    const char *p, *r;
+    char *ret, *w;
+
+    for (p = str; (p = strstr(p, search)) != NULL; p += slen)
+        ++qty;
+    if (qty == 0)
+        return NULL;
+
+    w = ret = malloc(strlen(str) + qty * rlen + 1);
+    for (r = str; (p = strstr(r, search)) != NULL; r = p + slen) {
+        memcpy(w, r, p - r);
+        memcpy(w + (p - r), replace, rlen);
+        w += (p - r) + rlen;
+    }
+    strcpy(w, r);
+
+    return ret;
+}
+
+// both variants against reference, `extra` free capacity in place
+static void check_replace_all(const char *str, const char *search, const char *replace, uint32_t extra) {
+    char *ref = replace_all_ref(str, search, replace);
+    String buf = string_new(strlen(str) + extra), ret;
+
+    string_copy(&buf, str);
+    ret = string_replace_all(buf, search, replace);
+    CHECK(ref == NULL ? ret == NULL : is(ret, ref));
+    CHECK(string_replace_all_self(&buf, search, replace) == (ref != NULL));
+    CHECK(is(buf, ref == NULL ? str : ref));
+
+    string_free(ret);
+    string_free(buf);
+    free(ref);
+}
+
+static void test_replace_all(void) {
+    static const char *const patterns[] = { "a", "b", "ab", "aa", "aba", "bab", "aaaa", "" };
+    static const char alphabet[] = "aab ";
+    uint32_t seed = 1;
+    char str[64];
+
+    // replacement does not create new matches, unlike a replace until not found loop
+    check_replace_all("    ", "  ", " ", 0);
+    SELF("IF  A   THEN    B", string_replace_all_self(&buf, "  ", " "), "IF A  THEN  B");
+    SELF("aabb", string_delete_all_self(&buf, "ab"), "ab");
+    SELF("aabb", string_delete_all_self(&buf, ""), NULL);
+    SELF("", string_replace_all_self(&buf, "a", "b"), NULL);
+
+    // shrinking, same length and growing, with and without free capacity
+    for (int round = 0; round < 20000; round++) {
+        uint32_t len = (seed = seed * 1103515245 + 12345) % sizeof(str);
+
+        for (uint32_t n = 0; n < len; n++)
+            str[n] = alphabet[(seed = seed * 1103515245 + 12345) >> 16 & 3];
+        str[len] = '\0';
+
+        const char *search = patterns[(seed >> 20) % 7];
+        const char *replace = patterns[(seed >> 24) % 8];
+
+        check_replace_all(str, search, replace, 0);
+        check_replace_all(str, search, replace, 4 * len);
+    }
+}
+
+////////////////
+
+int main(void) {
+    test_sso();
+    test_self();
+    test_replace_all();
+
+    printf("[checks: %ld, failures: %ld]\n", checks, failures);
+
+    return failures == 0 ? 0 : 1;
+}
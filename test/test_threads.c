@@ -0,0 +1,154 @@
+/**
+ * @file test_threads.c
+ * @brief Parse concurrently and compare with sequential parse
+ * @copyright 2023 Emiliano Augusto Gonzalez (hiperiondev). This project is released under MIT license. Contact: egonzalez.hiperion@gmail.com
+ * @see Project Site: https://github.com/hiperiondev/il_parser
+ * @note This is based on other projects. Please contact their authors for more information.
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Build (from repository root):
+ *   gcc -O2 -pthread -Isrc -Istringslib -Istringslib/siphash src/il_parser.c src/il_lexer.c src/il_arena.c src/il_alloc.c stringslib/strings.c \
+ *       stringslib/siphash/siphash.c stringslib/siphash/halfsiphash.c test/test_threads.c -o test_threads
+ *
+ * Run from repository root:
+ *   ./test_threads [threads] [rounds]
+ *
+ * Every source is parsed once sequentially with the console listener dumping
+ * to a memory stream. Then each thread parses all sources <rounds> times and
+ * compares its dump and diagnostics byte by byte with the sequential one.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "il_parser.h"
+
+#define SOURCES 3
+
+static const char test_errors[] =
+        "    LD %IX0.256\n"
+        "    JMP nowhere\n"
+        "    LD D#2023-13-01\n"
+        "    CAL FUNC (2, A:=1)\n"
+        "lbl: ST %QX0.0\n"
+        "    CAL FUNC2(\n"
+        "        A:=1,\n"
+        "(* not closed\n";
+
+typedef struct dump_s {
+      char *data; //
+    size_t len;   //
+} dump_t;
+
+typedef struct worker_s {
+    pthread_t thread;     //
+         long rounds;     //
+         long parses;     //
+         long mismatches; //
+} worker_t;
+
+static dump_t sequential[SOURCES];
+
+// console output and diagnostics of a parse
+static dump_t parse_dump(int source) {
+    il_listener_t listener = il_console_listener;
+    parsed_il_t parsed;
+    il_status_t status;
+    dump_t dump;
+    FILE *out;
+
+    out = open_memstream(&dump.data, &dump.len);
+    listener.ctx = out;
+
+    if (source < SOURCES - 1)
+        status = parse_file_il(source == 0 ? "test1.il" : "test2.il", &parsed, &listener);
+    else
+        status = parse_buffer_il(test_errors, sizeof(test_errors) - 1, &parsed, &listener);
+
+    fprintf(out, "[lines = %d, status = %d]\n", parsed.lines, status);
+    for (uint32_t n = 0; n < parsed.diag_qty; n++)
+        fprintf(out, "    [line: %d, column: %d] %s\n", parsed.diag[n].line, parsed.diag[n].column, parsed.diag[n].message->data);
+    free_parsed_il(&parsed);
+    fclose(out);
+
+    return dump;
+}
+
+static void* worker(void *arg) {
+    worker_t *w = arg;
+
+    for (long r = 0; r < w->rounds; r++) {
+        for (int source = 0; source < SOURCES; source++) {
+            dump_t dump = parse_dump(source);
+
+            if (dump.len != sequential[source].len || memcmp(dump.data, sequential[source].data, dump.len))
+                ++w->mismatches;
+            ++w->parses;
+            free(dump.data);
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    long threads = 8, rounds = 200, parses = 0, mismatches = 0;
+    worker_t *workers;
+
+    if (argc > 1)
+        threads = strtol(argv[1], NULL, 10);
+    if (argc > 2)
+        rounds = strtol(argv[2], NULL, 10);
+
+    for (int source = 0; source < SOURCES; source++)
+        sequential[source] = parse_dump(source);
+
+    workers = calloc(threads, sizeof(worker_t));
+    for (long n = 0; n < threads; n++) {
+        workers[n].rounds = rounds;
+        if (pthread_create(&(workers[n].thread), NULL, worker, &(workers[n])) != 0) {
+            fprintf(stderr, "ERROR: can't create thread\n");
+            return 1;
+        }
+    }
+
+    for (long n = 0; n < threads; n++) {
+        pthread_join(workers[n].thread, NULL);
+        parses += workers[n].parses;
+        mismatches += workers[n].mismatches;
+    }
+
+    printf("[threads: %ld, parses: %ld, mismatches: %ld]\n", threads, parses, mismatches);
+
+    for (int source = 0; source < SOURCES; source++)
+        free(sequential[source].data);
+    free(workers);
+
+    return mismatches == 0 ? 0 : 1;
+}